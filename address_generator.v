@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	address_generator.v
+//
+// Project:	address generator
+//
+// Purpose:	Nested loop address generator with per dimension bounds and
+//          strides, 1 address per clock.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// address_generator - address = base + i[0] * stride[0] + i[1] * stride[1] + ... , i[0] is the inner loop
+//  dimension n runs i[n] = 0 .. counts[n*COUNT_WIDTH+:COUNT_WIDTH], the count is the iterations - 1, with
+//  stride strides[n*ADDRESS_WIDTH+:ADDRESS_WIDTH]. start takes base, counts and strides and restarts the
+//  loops, every clock 'enable' is set while busy produces the next address. The last address clears busy.
+//  address, first and last are valid exactly LATENCY = TREE_LATENCY clocks after enable, first[n] / last[n]
+//  are set when i[n] is 0 / its count.
+//
+//  Every dimension is a counter_chunked loaded with ~count, its registered 'full' flag is the last iteration.
+//  A dimension steps when every inner dimension is full, so the cascade is an AND of registered flags, and
+//  wraps, reloads, when it is also full. The inner loop can be 1 iteration long and the loops still step
+//  every clock.
+//  The offset i[n] * stride[n] of every dimension is a math_pipelined_accumulator, ALU_WIDTH chunks with registered
+//  carries, the same as the 'systolic_array' cells, and base, the offset sums and the carries are added by a
+//  math_pipelined_adder_tree.
+module address_generator
+    #(
+        parameter DIMENSIONS    = 4,
+        parameter COUNT_WIDTH   = 8,
+        parameter ADDRESS_WIDTH = 22,
+        parameter ALU_WIDTH     = 8,
+        parameter TREE_LATENCY  = 2
+    )
+    (
+        input   wire                                    clk,
+        input   wire                                    rst,
+        input   wire                                    start,
+        input   wire    [ADDRESS_WIDTH-1:0]             base,
+        input   wire    [DIMENSIONS*COUNT_WIDTH-1:0]    counts,
+        input   wire    [DIMENSIONS*ADDRESS_WIDTH-1:0]  strides,
+        input   wire                                    enable,
+        output  wire                                    busy,
+        output  wire                                    out_valid,
+        output  wire    [ADDRESS_WIDTH-1:0]             address,
+        output  wire    [DIMENSIONS-1:0]                first,
+        output  wire    [DIMENSIONS-1:0]                last
+    );
+    localparam OPERANDS         = 1 + 2 * DIMENSIONS;   // base, then { carries, sum } of every dimension
+
+    reg                                 r_busy      = 0;
+    reg  [ADDRESS_WIDTH-1:0]            r_base      = 0;
+    reg  [DIMENSIONS*COUNT_WIDTH-1:0]   r_counts    = 0;
+    reg  [DIMENSIONS*ADDRESS_WIDTH-1:0] r_strides   = 0;
+    reg  [DIMENSIONS-1:0]               r_first     = 0;
+    wire [DIMENSIONS-1:0]               w_full;
+    wire                                w_advance   = r_busy && enable;
+    assign busy = r_busy;
+
+    // the step of each dimension, a dimension steps when all inner dimensions are full
+    wire [DIMENSIONS:0]                 w_step;
+    wire [DIMENSIONS-1:0]               w_wrap      = w_step[DIMENSIONS-1:0] & w_full;
+    assign w_step[0] = w_advance;
+
+    wire [OPERANDS*ADDRESS_WIDTH-1:0]   w_operands;
+    assign w_operands[ADDRESS_WIDTH-1:0] = r_base;
+
+    genvar dim;
+    generate
+        for( dim = 0; dim < DIMENSIONS; dim = dim + 1 ) begin : dimension_loop
+            assign w_step[dim+1] = w_step[dim] && w_full[dim];
+
+            counter_chunked #( .WIDTH( COUNT_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) index_counter
+            (
+                .clk(           clk ),
+                .rst(           rst ),
+                .load(          start || w_wrap[dim] ),
+                .load_value(    start ? ~counts[dim*COUNT_WIDTH+:COUNT_WIDTH] : ~r_counts[dim*COUNT_WIDTH+:COUNT_WIDTH] ),
+                .enable(        w_step[dim] ),
+                .count(),
+                .full(          w_full[dim] )
+            );
+
+            // offset accumulator, { carries, sum }, cleared on start and wrap
+            wire [ADDRESS_WIDTH-1:0] w_sum;
+            wire [ADDRESS_WIDTH-1:0] w_carry_positions;
+            math_pipelined_accumulator #( .WIDTH( ADDRESS_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) offset_accumulator
+            (
+                .clk(           clk ),
+                .clear(         start || w_wrap[dim] ),
+                .enable(        w_step[dim] ),
+                .restart(       1'b0 ),
+                .I1(            r_strides[dim*ADDRESS_WIDTH+:ADDRESS_WIDTH] ),
+                .next_sum(),
+                .next_carries(),
+                .sum(           w_sum ),
+                .carries(       w_carry_positions )
+            );
+            assign w_operands[(1+2*dim)*ADDRESS_WIDTH+:2*ADDRESS_WIDTH] = { w_carry_positions, w_sum };
+        end
+    endgenerate
+
+    always @( posedge clk ) begin
+        if( start ) begin
+            r_base      <= base;
+            r_counts    <= counts;
+            r_strides   <= strides;
+            r_first     <= { DIMENSIONS{1'b1} };
+        end else begin
+            // a dimension is at 0 after it wraps, and not after it steps
+            r_first     <= ( r_first & ~w_step[DIMENSIONS-1:0] ) | w_wrap;
+        end
+        if( rst )
+            r_busy <= 1'b0;
+        else if( start )
+            r_busy <= 1'b1;
+        else if( w_step[DIMENSIONS] )
+            r_busy <= 1'b0;
+    end
+
+    math_pipelined_adder_tree #( .WIDTH( ADDRESS_WIDTH ), .COUNT( OPERANDS ), .LATENCY( TREE_LATENCY ) ) address_tree
+    (
+        .clk(   clk ),
+        .I1(    w_operands ),
+        .sum(   address )
+    );
+    ff_delay #( .WIDTH( 1 + 2 * DIMENSIONS ), .DEPTH( TREE_LATENCY ) ) flag_delay
+    (
+        .clk(   clk ),
+        .D(     { w_advance, r_first, w_full } ),
+        .Q(     { out_valid, first, last } )
+    );
+endmodule
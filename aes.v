@@ -0,0 +1,319 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	aes.v
+//
+// Project:	aes
+//
+// Purpose:	Fully pipelined AES-128/192/256 encryption engine. 1 block per clock
+//          in ECB or CTR mode.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// aes_sbox - the aes s-box of I1.
+//  REGISTERED  - 1: sbox is valid 1 clock after I1. 0: asynchronous read
+//  STYLE       - "block_rom": a 256 x 8 block rom generated at elaboration time, REGISTERED must be 1
+//                "distributed_rom": the same rom in LUTs
+//                "composite": no rom, the inverse is computed in GF((2^4)^2), see aes_functions.v. The
+//                GF(2^4) inverse is a 4 input function and the maps in and out are small xor trees
+module aes_sbox
+    #(
+        parameter REGISTERED    = 1,
+        parameter STYLE         = "block_rom"
+    )
+    (
+        input   wire        clk,
+        input   wire [7:0]  I1,
+        output  wire [7:0]  sbox
+    );
+    `ifndef FORMAL
+        `include "./toolbox/aes_functions.v"
+    `else
+        `include "aes_functions.v"
+    `endif
+    integer idx;
+    wire [7:0] w_sbox;
+    generate
+        if( STYLE == "composite" ) begin
+            assign w_sbox = f_AesFromComposite( f_AesCompositeInverse( f_AesToComposite( I1 ) ) ) ^ 8'h63;
+        end else if( STYLE == "block_rom" ) begin
+            (* syn_romstyle = "block_rom" *) reg [7:0] r_rom [0:255];
+            initial for( idx = 0; idx < 256; idx = idx + 1 ) r_rom[idx] = f_AesSbox( idx );
+            assign w_sbox = r_rom[I1];
+        end else begin
+            (* syn_romstyle = "distributed_rom" *) reg [7:0] r_rom [0:255];
+            initial for( idx = 0; idx < 256; idx = idx + 1 ) r_rom[idx] = f_AesSbox( idx );
+            assign w_sbox = r_rom[I1];
+        end
+        if( REGISTERED ) begin
+            reg [7:0] r_sbox = 0;
+            always @( posedge clk ) r_sbox <= w_sbox;
+            assign sbox = r_sbox;
+        end else begin
+            assign sbox = w_sbox;
+        end
+    endgenerate
+endmodule
+
+// aes_key_expansion - precomputes every round key when 'key_load' is HIGH.
+// 1 word of the key schedule is built each clock using 4 distributed s-boxes.
+// 'key_ready' goes HIGH once the whole schedule is built, 4 * ( ROUNDS + 1 ) - KEY_WIDTH / 32 clocks after 'key_load'.
+// Nothing is expanded until a key is loaded, 'rst' drops 'key_ready' and stops an expansion, load the key again.
+// The schedule is held in a shift register, new words are shifted into the bottom,
+// round key 'n' is round_keys[(ROUNDS-n)*128+:128]
+module aes_key_expansion
+    #(
+        parameter KEY_WIDTH = 128
+    )
+    (
+        clk, rst, key_load, key, round_keys, key_ready
+    );
+    localparam ROUNDS       = KEY_WIDTH == 256 ? 14 : KEY_WIDTH == 192 ? 12 : 10;
+    localparam KEY_WORDS    = KEY_WIDTH / 32;
+    localparam TOTAL_WORDS  = 4 * ( ROUNDS + 1 );
+
+    input   wire                            clk;
+    input   wire                            rst;
+    input   wire                            key_load;
+    input   wire    [KEY_WIDTH-1:0]         key;
+    output  wire    [TOTAL_WORDS*32-1:0]    round_keys;
+    output  wire                            key_ready;
+
+    reg [TOTAL_WORDS*32-1:0]    r_schedule  = 0;
+    reg [7:0]                   r_step      = 0;
+    reg [3:0]                   r_phase     = 0;    // word index mod KEY_WORDS
+    reg [7:0]                   r_rcon      = 8'h01;
+    reg                         r_busy      = 0;    // expanding a loaded key
+    reg                         r_ready     = 0;
+    assign round_keys   = r_schedule;
+    assign key_ready    = r_ready;
+
+    // w[i-1] is the bottom word, w[i-KEY_WORDS] is KEY_WORDS-1 words up
+    wire [31:0] w_previous  = r_schedule[31:0];
+    wire [31:0] w_oldest    = r_schedule[(KEY_WORDS-1)*32+:32];
+    wire [31:0] w_sub_in    = r_phase == 0 ? { w_previous[23:0], w_previous[31:24] } : w_previous;
+    wire [31:0] w_sub_out;
+    genvar idx;
+    generate
+        for( idx = 0; idx < 4; idx = idx + 1 ) begin : key_sbox_loop
+            aes_sbox #( .REGISTERED( 0 ), .STYLE( "distributed_rom" ) ) key_sbox ( .clk( clk ), .I1( w_sub_in[idx*8+:8] ), .sbox( w_sub_out[idx*8+:8] ) );
+        end
+    endgenerate
+    wire [31:0] w_temp      = r_phase == 0                      ? w_sub_out ^ { r_rcon, 24'd0 }
+                            : (KEY_WORDS > 6 && r_phase == 4)   ? w_sub_out
+                            : w_previous;
+
+    always @( posedge clk ) begin
+        if( key_load ) begin
+            r_schedule  <= key;
+            r_step      <= 'd0;
+            r_phase     <= 'd0;
+            r_rcon      <= 8'h01;
+            r_busy      <= 1'b1;
+            r_ready     <= 1'b0;
+        end else if( r_busy ) begin
+            r_schedule  <= { r_schedule[(TOTAL_WORDS-1)*32-1:0], w_oldest ^ w_temp };
+            r_step      <= r_step + 1'b1;
+            r_phase     <= r_phase == KEY_WORDS - 1 ? 'd0 : r_phase + 1'b1;
+            if( r_phase == 0 )
+                r_rcon  <= { r_rcon[6:0], 1'b0 } ^ ( r_rcon[7] ? 8'h1B : 8'h00 );
+            if( r_step == TOTAL_WORDS - KEY_WORDS - 1 ) begin
+                r_busy  <= 1'b0;
+                r_ready <= 1'b1;
+            end
+        end
+        if( rst ) begin
+            r_busy      <= 1'b0;
+            r_ready     <= 1'b0;
+            r_step      <= 'd0;
+            r_phase     <= 'd0;
+        end
+    end
+endmodule
+
+// aes_pipelined - AES encryption, 1 block per clock.
+//  KEY_WIDTH       - 128, 192 or 256
+//  ROUND_LATENCY   - clocks per round. The s-boxes are always registered, the remaining
+//                    ROUND_LATENCY - 1 clocks are used by the mix columns xor trees.
+//  MODE            - "ECB": out_data = E(in_data)
+//                    "CTR": out_data = in_data ^ E({ nonce, counter }). The counter is the low
+//                    'CTR_WIDTH' bits of the block, loaded from ctr_iv with 'ctr_load' and
+//                    incremented every 'in_valid'. CTR_WIDTH 32 is the GCM inc32 function.
+//  SBOX_STYLE      - "composite": GF((2^4)^2) inverse logic, no roms, the fewest LUTs and no BSRAM
+//                    "block_rom": 1 block rom per s-box, 16 per round, 160 for a 128 bit key, more
+//                    than the 26 BSRAMs of a GW1NR-9
+//                    "distributed_rom": 1 LUT rom per s-box
+//
+// Load the key with 'key_load', wait for 'key_ready' before sending data.
+// out_data is valid ROUNDS * ROUND_LATENCY + 2 clocks after in_data.
+//  stage 0             - state = block ^ round_key[0]
+//  stage 1..ROUNDS     - sub bytes ( registered s-box ), shift rows, mix columns and add round key.
+//                        Mix columns is linear, each output bit is a 'math_pipelined_reduce' xor tree of
+//                        the column bits picked by the mix columns bit matrix plus the round key bit.
+//                        The last round skips mix columns.
+//  output              - out_data = state, or state ^ in_data in CTR mode
+module aes_pipelined
+    #(
+        parameter KEY_WIDTH     = 128,
+        parameter ROUND_LATENCY = 1,
+        parameter MODE          = "ECB",
+        parameter CTR_WIDTH     = 32,
+        parameter CTR_ALU_WIDTH = 8,
+        parameter SBOX_STYLE    = "composite"
+    )
+    (
+        input   wire                    clk,
+        input   wire                    rst,
+        input   wire                    key_load,
+        input   wire [KEY_WIDTH-1:0]    key,
+        output  wire                    key_ready,
+        input   wire                    ctr_load,
+        input   wire [127:0]            ctr_iv,
+        input   wire                    in_valid,
+        input   wire [127:0]            in_data,
+        output  wire                    out_valid,
+        output  wire [127:0]            out_data
+    );
+    `ifndef FORMAL
+        `include "./toolbox/aes_functions.v"
+    `else
+        `include "aes_functions.v"
+    `endif
+    localparam ROUNDS   = KEY_WIDTH == 256 ? 14 : KEY_WIDTH == 192 ? 12 : 10;
+    localparam LATENCY  = ROUNDS * ROUND_LATENCY + 2;
+
+    wire [(ROUNDS+1)*128-1:0] w_round_keys;
+    aes_key_expansion #( .KEY_WIDTH( KEY_WIDTH ) ) key_expansion
+    (
+        .clk(           clk ),
+        .rst(           rst ),
+        .key_load(      key_load ),
+        .key(           key ),
+        .round_keys(    w_round_keys ),
+        .key_ready(     key_ready )
+    );
+    `define aes_round_key(n) w_round_keys[(ROUNDS-(n))*128+:128]
+
+    // select the block to encrypt
+    wire [127:0] w_block;
+    generate
+        if( MODE == "CTR" ) begin
+            reg  [127:0]            r_nonce = 0;
+            wire [CTR_WIDTH-1:0]    w_counter;
+            always @( posedge clk ) if( ctr_load ) r_nonce <= ctr_iv;
+            counter_chunked #( .WIDTH( CTR_WIDTH ), .ALU_WIDTH( CTR_ALU_WIDTH ) ) ctr_counter
+            (
+                .clk(           clk ),
+                .rst(           rst ),
+                .load(          ctr_load ),
+                .load_value(    ctr_iv[CTR_WIDTH-1:0] ),
+                .enable(        in_valid ),
+                .count(         w_counter )
+            );
+            if( CTR_WIDTH < 128 )
+                assign w_block = { r_nonce[127:CTR_WIDTH], w_counter };
+            else
+                assign w_block = w_counter;
+        end else begin
+            assign w_block = in_data;
+        end
+    endgenerate
+
+    // stage 0, initial add round key
+    wire [128*(ROUNDS+1)-1:0] w_state;
+    reg  [127:0] r_initial = 0;
+    always @( posedge clk ) r_initial <= w_block ^ `aes_round_key(0);
+    assign w_state[127:0] = r_initial;
+
+    genvar round;
+    genvar idx;
+    genvar column;
+    genvar out_bit;
+    genvar in_bit;
+    generate
+        for( round = 1; round <= ROUNDS; round = round + 1 ) begin : aes_round_loop
+            wire [127:0] w_round_in = w_state[(round-1)*128+:128];
+            wire [127:0] w_round_key;
+            // sub bytes, byte 'n' of the state is bits [127-8n-:8]
+            wire [127:0] w_sub_bytes;
+            for( idx = 0; idx < 16; idx = idx + 1 ) begin : aes_sbox_loop
+                aes_sbox #( .REGISTERED( 1 ), .STYLE( SBOX_STYLE ) ) round_sbox ( .clk( clk ), .I1( w_round_in[127-8*idx-:8] ), .sbox( w_sub_bytes[127-8*idx-:8] ) );
+            end
+            // shift rows, state byte 'row + 4 * column' moves to column - row
+            wire [127:0] w_shift_rows;
+            for( idx = 0; idx < 16; idx = idx + 1 ) begin : aes_shift_rows_loop
+                assign w_shift_rows[127-8*idx-:8] = w_sub_bytes[127-8*( idx % 4 + 4 * ( ( idx / 4 + idx % 4 ) % 4 ) )-:8];
+            end
+            assign w_round_key = `aes_round_key(round);
+            if( round != ROUNDS ) begin
+                // mix columns and add round key
+                for( column = 0; column < 4; column = column + 1 ) begin : aes_mix_column_loop
+                    wire [31:0] w_column = w_shift_rows[127-32*column-:32];
+                    for( out_bit = 0; out_bit < 32; out_bit = out_bit + 1 ) begin : aes_mix_bit_loop
+                        wire [32:0] w_terms;
+                        for( in_bit = 0; in_bit < 32; in_bit = in_bit + 1 ) begin : aes_mix_term_loop
+                            localparam [31:0] MIX_COLUMN = f_AesMixColumn( 32'd1 << in_bit );
+                            assign w_terms[in_bit] = w_column[in_bit] & MIX_COLUMN[out_bit];
+                        end
+                        assign w_terms[32] = w_round_key[127-32*column-31+out_bit];
+                        math_pipelined_reduce #( .WIDTH( 33 ), .LATENCY( ROUND_LATENCY - 1 ), .OPERATION( "XOR" ) ) mix_tree
+                        (
+                            .clk(       clk ),
+                            .I1(        w_terms ),
+                            .result(    w_state[round*128+127-32*column-31+out_bit] )
+                        );
+                    end
+                end
+            end else begin
+                // last round, add round key only
+                ff_delay #( .WIDTH( 128 ), .DEPTH( ROUND_LATENCY - 1 ) ) last_round_delay
+                (
+                    .clk(   clk ),
+                    .D(     w_shift_rows ^ w_round_key ),
+                    .Q(     w_state[round*128+:128] )
+                );
+            end
+        end
+    endgenerate
+    `undef aes_round_key
+
+    // output stage
+    wire [127:0]    w_text;
+    reg  [127:0]    r_out   = 0;
+    reg  [LATENCY-1:0] r_valid = 0;
+    assign out_data     = r_out;
+    assign out_valid    = r_valid[LATENCY-1];
+    generate
+        if( MODE == "CTR" ) begin
+            ff_delay #( .WIDTH( 128 ), .DEPTH( LATENCY - 1 ) ) text_delay ( .clk( clk ), .D( in_data ), .Q( w_text ) );
+        end else begin
+            assign w_text = 128'd0;
+        end
+    endgenerate
+    always @( posedge clk ) begin
+        r_out <= w_state[ROUNDS*128+:128] ^ w_text;
+        if( rst )
+            r_valid <= 'd0;
+        else
+            r_valid <= { r_valid[LATENCY-2:0], in_valid };
+    end
+endmodule
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	aes_functions.v
+//
+// Project:	aes
+//
+// Purpose:	functions used to build the aes s-box and mix columns tables at
+//          elaboration time, and the composite field s-box logic.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+
+//  f_AesMultiply - Returns a * b in GF(2^8) mod x^8 + x^4 + x^3 + x + 1
+function automatic [7:0] f_AesMultiply;
+    input [7:0] a, b;
+    integer idx;
+    begin
+        f_AesMultiply = 0;
+        for( idx = 0; idx < 8; idx = idx + 1 ) begin
+            if( b[idx] )
+                f_AesMultiply = f_AesMultiply ^ a;
+            a = { a[6:0], 1'b0 } ^ ( a[7] ? 8'h1B : 8'h00 );
+        end
+    end
+endfunction
+
+//  f_AesSbox - Returns the s-box value, the multiplicative inverse (x**254) followed by the affine transform
+function automatic [7:0] f_AesSbox;
+    input [7:0] x;
+    reg   [7:0] inverse;
+    integer idx;
+    begin
+        inverse = 1;
+        for( idx = 0; idx < 254; idx = idx + 1 )
+            inverse = f_AesMultiply( inverse, x );
+        f_AesSbox = inverse ^ { inverse[6:0], inverse[7] } ^ { inverse[5:0], inverse[7:6] }
+                            ^ { inverse[4:0], inverse[7:5] } ^ { inverse[3:0], inverse[7:4] } ^ 8'h63;
+    end
+endfunction
+
+//  f_AesMixColumn - Returns mix columns of a single column, { s0, s1, s2, s3 } with s0 in the msb
+//  Mix columns is linear, f_AesMixColumn( 1 << n ) is the n'th column of its bit matrix
+function automatic [31:0] f_AesMixColumn;
+    input [31:0] column;
+    reg   [7:0] s0, s1, s2, s3;
+    begin
+        { s0, s1, s2, s3 } = column;
+        f_AesMixColumn = {
+            f_AesMultiply( s0, 2 ) ^ f_AesMultiply( s1, 3 ) ^ s2 ^ s3,
+            s0 ^ f_AesMultiply( s1, 2 ) ^ f_AesMultiply( s2, 3 ) ^ s3,
+            s0 ^ s1 ^ f_AesMultiply( s2, 2 ) ^ f_AesMultiply( s3, 3 ),
+            f_AesMultiply( s0, 3 ) ^ s1 ^ s2 ^ f_AesMultiply( s3, 2 ) };
+    end
+endfunction
+
+//  f_Gf16Multiply - Returns a * b in GF(2^4) mod x^4 + x + 1
+function automatic [3:0] f_Gf16Multiply;
+    input [3:0] a, b;
+    integer idx;
+    begin
+        f_Gf16Multiply = 0;
+        for( idx = 0; idx < 4; idx = idx + 1 ) begin
+            if( b[idx] )
+                f_Gf16Multiply = f_Gf16Multiply ^ a;
+            a = { a[2:0], 1'b0 } ^ ( a[3] ? 4'h3 : 4'h0 );
+        end
+    end
+endfunction
+
+//  f_Gf16Inverse - Returns x**14, the inverse of x in GF(2^4), 0 for 0. A 4 input function, 1 LUT4 per bit
+function automatic [3:0] f_Gf16Inverse;
+    input [3:0] x;
+    integer idx;
+    begin
+        f_Gf16Inverse = 1;
+        for( idx = 0; idx < 14; idx = idx + 1 )
+            f_Gf16Inverse = f_Gf16Multiply( f_Gf16Inverse, x );
+    end
+endfunction
+
+// The composite field is GF((2^4)^2) mod y^2 + y + 8 over GF(2^4) mod x^4 + x + 1, an element is
+// { high, low } = high * y + low. 8'h20 is a root of the aes polynomial x^8 + x^4 + x^3 + x + 1 in it,
+// so bit n of an aes byte maps to 8'h20**n. Both maps are bit matrices, xor trees of at most 8 bits.
+
+//  f_AesToComposite - Returns the composite field element of the aes byte x
+function automatic [7:0] f_AesToComposite;
+    input [7:0] x;
+    reg   [63:0] columns;
+    integer idx;
+    begin
+        columns = 64'he5_34_d5_3c_4c_46_20_01;     // 8'h20**n, n = 7 .. 0
+        f_AesToComposite = 0;
+        for( idx = 0; idx < 8; idx = idx + 1 )
+            if( x[idx] )
+                f_AesToComposite = f_AesToComposite ^ columns[idx*8+:8];
+    end
+endfunction
+
+//  f_AesFromComposite - Returns the aes byte of the composite field element x, with the linear part of the
+//  s-box affine transform folded in, the 8'h63 is left to the caller
+function automatic [7:0] f_AesFromComposite;
+    input [7:0] x;
+    reg   [63:0] columns;
+    integer idx;
+    begin
+        columns = 64'h60_65_3e_52_36_ab_b2_1f;
+        f_AesFromComposite = 0;
+        for( idx = 0; idx < 8; idx = idx + 1 )
+            if( x[idx] )
+                f_AesFromComposite = f_AesFromComposite ^ columns[idx*8+:8];
+    end
+endfunction
+
+//  f_AesCompositeInverse - Returns the inverse of x in the composite field, 0 for 0
+//  ( high * y + low )**-1 = ( high * y + high + low ) / ( high * high * 8 + high * low + low * low )
+function automatic [7:0] f_AesCompositeInverse;
+    input [7:0] x;
+    reg   [3:0] delta;
+    begin
+        delta = f_Gf16Multiply( f_Gf16Multiply( x[7:4], x[7:4] ), 4'h8 ) ^ f_Gf16Multiply( x[7:4], x[3:0] ) ^ f_Gf16Multiply( x[3:0], x[3:0] );
+        delta = f_Gf16Inverse( delta );
+        f_AesCompositeInverse = { f_Gf16Multiply( x[7:4], delta ), f_Gf16Multiply( x[7:4] ^ x[3:0], delta ) };
+    end
+endfunction
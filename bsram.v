@@ -0,0 +1,720 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	bsram.v
+//
+// Project:	bsram
+//
+// Purpose:	Simulation models of the Gowin block and shadow sram primitives and
+//          a pipelined memory wrapper.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+`ifdef FORMAL
+    `define TEST_BENCH_RUNNING
+`endif
+`ifdef TEST_BENCH_RUNNING
+    `define SDPB_PRIMITIVE      sdpb_simulation_wrapper
+    `define RAM16SDP4_PRIMITIVE ram16sdp4_simulation_wrapper
+`else
+    `define SDPB_PRIMITIVE      SDPB
+    `define RAM16SDP4_PRIMITIVE RAM16SDP4
+`endif
+
+// the 64 INIT_RAM_xx parameters of a 16K bit block, INIT_RAM_00 holds bits 255:0
+`define BSRAM_INIT_PARAMETERS \
+    parameter INIT_RAM_00 = 256'h0, \
+    parameter INIT_RAM_01 = 256'h0, \
+    parameter INIT_RAM_02 = 256'h0, \
+    parameter INIT_RAM_03 = 256'h0, \
+    parameter INIT_RAM_04 = 256'h0, \
+    parameter INIT_RAM_05 = 256'h0, \
+    parameter INIT_RAM_06 = 256'h0, \
+    parameter INIT_RAM_07 = 256'h0, \
+    parameter INIT_RAM_08 = 256'h0, \
+    parameter INIT_RAM_09 = 256'h0, \
+    parameter INIT_RAM_0A = 256'h0, \
+    parameter INIT_RAM_0B = 256'h0, \
+    parameter INIT_RAM_0C = 256'h0, \
+    parameter INIT_RAM_0D = 256'h0, \
+    parameter INIT_RAM_0E = 256'h0, \
+    parameter INIT_RAM_0F = 256'h0, \
+    parameter INIT_RAM_10 = 256'h0, \
+    parameter INIT_RAM_11 = 256'h0, \
+    parameter INIT_RAM_12 = 256'h0, \
+    parameter INIT_RAM_13 = 256'h0, \
+    parameter INIT_RAM_14 = 256'h0, \
+    parameter INIT_RAM_15 = 256'h0, \
+    parameter INIT_RAM_16 = 256'h0, \
+    parameter INIT_RAM_17 = 256'h0, \
+    parameter INIT_RAM_18 = 256'h0, \
+    parameter INIT_RAM_19 = 256'h0, \
+    parameter INIT_RAM_1A = 256'h0, \
+    parameter INIT_RAM_1B = 256'h0, \
+    parameter INIT_RAM_1C = 256'h0, \
+    parameter INIT_RAM_1D = 256'h0, \
+    parameter INIT_RAM_1E = 256'h0, \
+    parameter INIT_RAM_1F = 256'h0, \
+    parameter INIT_RAM_20 = 256'h0, \
+    parameter INIT_RAM_21 = 256'h0, \
+    parameter INIT_RAM_22 = 256'h0, \
+    parameter INIT_RAM_23 = 256'h0, \
+    parameter INIT_RAM_24 = 256'h0, \
+    parameter INIT_RAM_25 = 256'h0, \
+    parameter INIT_RAM_26 = 256'h0, \
+    parameter INIT_RAM_27 = 256'h0, \
+    parameter INIT_RAM_28 = 256'h0, \
+    parameter INIT_RAM_29 = 256'h0, \
+    parameter INIT_RAM_2A = 256'h0, \
+    parameter INIT_RAM_2B = 256'h0, \
+    parameter INIT_RAM_2C = 256'h0, \
+    parameter INIT_RAM_2D = 256'h0, \
+    parameter INIT_RAM_2E = 256'h0, \
+    parameter INIT_RAM_2F = 256'h0, \
+    parameter INIT_RAM_30 = 256'h0, \
+    parameter INIT_RAM_31 = 256'h0, \
+    parameter INIT_RAM_32 = 256'h0, \
+    parameter INIT_RAM_33 = 256'h0, \
+    parameter INIT_RAM_34 = 256'h0, \
+    parameter INIT_RAM_35 = 256'h0, \
+    parameter INIT_RAM_36 = 256'h0, \
+    parameter INIT_RAM_37 = 256'h0, \
+    parameter INIT_RAM_38 = 256'h0, \
+    parameter INIT_RAM_39 = 256'h0, \
+    parameter INIT_RAM_3A = 256'h0, \
+    parameter INIT_RAM_3B = 256'h0, \
+    parameter INIT_RAM_3C = 256'h0, \
+    parameter INIT_RAM_3D = 256'h0, \
+    parameter INIT_RAM_3E = 256'h0, \
+    parameter INIT_RAM_3F = 256'h0,
+`define BSRAM_INIT_VECTOR { \
+    INIT_RAM_3F, INIT_RAM_3E, INIT_RAM_3D, INIT_RAM_3C, INIT_RAM_3B, INIT_RAM_3A, INIT_RAM_39, INIT_RAM_38, \
+    INIT_RAM_37, INIT_RAM_36, INIT_RAM_35, INIT_RAM_34, INIT_RAM_33, INIT_RAM_32, INIT_RAM_31, INIT_RAM_30, \
+    INIT_RAM_2F, INIT_RAM_2E, INIT_RAM_2D, INIT_RAM_2C, INIT_RAM_2B, INIT_RAM_2A, INIT_RAM_29, INIT_RAM_28, \
+    INIT_RAM_27, INIT_RAM_26, INIT_RAM_25, INIT_RAM_24, INIT_RAM_23, INIT_RAM_22, INIT_RAM_21, INIT_RAM_20, \
+    INIT_RAM_1F, INIT_RAM_1E, INIT_RAM_1D, INIT_RAM_1C, INIT_RAM_1B, INIT_RAM_1A, INIT_RAM_19, INIT_RAM_18, \
+    INIT_RAM_17, INIT_RAM_16, INIT_RAM_15, INIT_RAM_14, INIT_RAM_13, INIT_RAM_12, INIT_RAM_11, INIT_RAM_10, \
+    INIT_RAM_0F, INIT_RAM_0E, INIT_RAM_0D, INIT_RAM_0C, INIT_RAM_0B, INIT_RAM_0A, INIT_RAM_09, INIT_RAM_08, \
+    INIT_RAM_07, INIT_RAM_06, INIT_RAM_05, INIT_RAM_04, INIT_RAM_03, INIT_RAM_02, INIT_RAM_01, INIT_RAM_00 }
+
+// bsram_simulation_model - 16K bit block sram with 2 ports, the common core of the SP, SDPB, DPB
+// and pROM models. Port 0 is A, port 1 is B.
+//  BIT_WIDTH   - 1, 2, 4, 8, 16 or 32. AD[13:log2( BIT_WIDTH )] is the word address, for 16 bits
+//                AD[1:0] and for 32 bits AD[3:0] are the byte write enables
+//  READ_MODE   - 0: bypass, DO is the read register. 1: pipeline, DO is an extra register clocked by OCE
+//  WRITE_MODE  - 0: normal, the read register holds during a write. 1: write through, the read register
+//                takes the written word. 2: read before write, the read register takes the old word
+//  BLK_SEL     - the port is enabled when BLKSEL matches
+//  RESET_MODE  - "SYNC" or "ASYNC", RESET clears the output registers, never the memory
+module bsram_simulation_model
+    #(
+        parameter READ_MODE0    = 1'b0,
+        parameter READ_MODE1    = 1'b0,
+        parameter WRITE_MODE0   = 2'b00,
+        parameter WRITE_MODE1   = 2'b00,
+        parameter BIT_WIDTH_0   = 32,
+        parameter BIT_WIDTH_1   = 32,
+        parameter BLK_SEL_0     = 3'b000,
+        parameter BLK_SEL_1     = 3'b000,
+        parameter RESET_MODE    = "SYNC",
+        parameter INIT          = 16384'h0
+    )
+    (
+        input   wire    [1:0]   CLK,
+        input   wire    [1:0]   CE,
+        input   wire    [1:0]   OCE,
+        input   wire    [1:0]   RESET,
+        input   wire    [1:0]   WRE,
+        input   wire    [5:0]   BLKSEL,
+        input   wire    [27:0]  AD,
+        input   wire    [63:0]  DI,
+        output  wire    [63:0]  DO
+    );
+    reg [16383:0] r_memory = INIT;
+
+    genvar port;
+    generate
+        for( port = 0; port < 2; port = port + 1 ) begin : bsram_port_loop
+            localparam BIT_WIDTH    = port == 0 ? BIT_WIDTH_0 : BIT_WIDTH_1;
+            localparam READ_MODE    = port == 0 ? READ_MODE0 : READ_MODE1;
+            localparam WRITE_MODE   = port == 0 ? WRITE_MODE0 : WRITE_MODE1;
+            localparam BLK_SEL      = port == 0 ? BLK_SEL_0 : BLK_SEL_1;
+            localparam ADDRESS_LSB  = BIT_WIDTH == 32 ? 5 : BIT_WIDTH == 16 ? 4 : BIT_WIDTH == 8 ? 3 : BIT_WIDTH == 4 ? 2 : BIT_WIDTH == 2 ? 1 : 0;
+            wire [13:0]             w_address   = AD[port*14+:14];
+            wire [31:0]             w_data      = DI[port*32+:32];
+            wire [13:0]             w_offset    = { w_address[13:ADDRESS_LSB], { ADDRESS_LSB{1'b0} } };
+            wire [3:0]              w_bytes     = BIT_WIDTH == 32 ? w_address[3:0] : BIT_WIDTH == 16 ? { 2'b00, w_address[1:0] } : 4'b1111;
+            wire                    w_select    = BLKSEL[port*3+:3] == BLK_SEL;
+            wire                    w_reset     = RESET_MODE == "ASYNC" ? RESET[port] : 1'b0;
+            reg  [BIT_WIDTH-1:0]    r_read      = 0;
+            reg  [BIT_WIDTH-1:0]    r_pipe      = 0;
+            integer idx;
+            always @( posedge CLK[port] or posedge w_reset ) begin
+                if( w_reset || RESET[port] ) begin
+                    r_read <= 'd0;
+                    r_pipe <= 'd0;
+                end else begin
+                    if( CE[port] && w_select ) begin
+                        if( WRE[port] ) begin
+                            for( idx = 0; idx < BIT_WIDTH; idx = idx + 1 )
+                                if( BIT_WIDTH < 16 || w_bytes[idx/8] )
+                                    r_memory[w_offset+idx] <= w_data[idx];
+                            if( WRITE_MODE == 2'b01 )
+                                r_read <= w_data[BIT_WIDTH-1:0];
+                            else if( WRITE_MODE == 2'b10 )
+                                r_read <= r_memory[w_offset+:BIT_WIDTH];
+                        end else begin
+                            r_read <= r_memory[w_offset+:BIT_WIDTH];
+                        end
+                    end
+                    if( OCE[port] )
+                        r_pipe <= r_read;
+                end
+            end
+            assign DO[port*32+:32] = READ_MODE ? r_pipe : r_read;
+        end
+    endgenerate
+endmodule
+
+// sp_simulation_wrapper - SP, single port, 1 read / write port
+module sp_simulation_wrapper
+    #(
+        parameter READ_MODE     = 1'b0,
+        parameter WRITE_MODE    = 2'b00,
+        parameter BIT_WIDTH     = 32,
+        parameter BLK_SEL       = 3'b000,
+        `BSRAM_INIT_PARAMETERS
+        parameter RESET_MODE    = "SYNC"
+    )
+    (
+        output  wire    [31:0]  DO,
+        input   wire    [31:0]  DI,
+        input   wire    [2:0]   BLKSEL,
+        input   wire    [13:0]  AD,
+        input   wire            WRE,
+        input   wire            CLK,
+        input   wire            CE,
+        input   wire            OCE,
+        input   wire            RESET
+    );
+    wire [63:0] w_DO;
+    assign DO = w_DO[31:0];
+    bsram_simulation_model
+        #(
+            .READ_MODE0(    READ_MODE ),
+            .WRITE_MODE0(   WRITE_MODE ),
+            .BIT_WIDTH_0(   BIT_WIDTH ),
+            .BLK_SEL_0(     BLK_SEL ),
+            .RESET_MODE(    RESET_MODE ),
+            .INIT(          `BSRAM_INIT_VECTOR )
+        )
+        memory
+        (
+            .CLK(       { 1'b0, CLK } ),
+            .CE(        { 1'b0, CE } ),
+            .OCE(       { 1'b0, OCE } ),
+            .RESET(     { 1'b0, RESET } ),
+            .WRE(       { 1'b0, WRE } ),
+            .BLKSEL(    { 3'b000, BLKSEL } ),
+            .AD(        { 14'd0, AD } ),
+            .DI(        { 32'd0, DI } ),
+            .DO(        w_DO )
+        );
+endmodule
+
+// sdpb_simulation_wrapper - SDPB, semi dual port, port A writes and port B reads
+module sdpb_simulation_wrapper
+    #(
+        parameter READ_MODE     = 1'b0,
+        parameter BIT_WIDTH_0   = 32,
+        parameter BIT_WIDTH_1   = 32,
+        parameter BLK_SEL_0     = 3'b000,
+        parameter BLK_SEL_1     = 3'b000,
+        `BSRAM_INIT_PARAMETERS
+        parameter RESET_MODE    = "SYNC"
+    )
+    (
+        output  wire    [31:0]  DO,
+        input   wire    [31:0]  DI,
+        input   wire    [2:0]   BLKSELA,
+        input   wire    [2:0]   BLKSELB,
+        input   wire    [13:0]  ADA,
+        input   wire    [13:0]  ADB,
+        input   wire            CLKA,
+        input   wire            CLKB,
+        input   wire            CEA,
+        input   wire            CEB,
+        input   wire            OCE,
+        input   wire            RESETA,
+        input   wire            RESETB
+    );
+    wire [63:0] w_DO;
+    assign DO = w_DO[63:32];
+    bsram_simulation_model
+        #(
+            .READ_MODE1(    READ_MODE ),
+            .BIT_WIDTH_0(   BIT_WIDTH_0 ),
+            .BIT_WIDTH_1(   BIT_WIDTH_1 ),
+            .BLK_SEL_0(     BLK_SEL_0 ),
+            .BLK_SEL_1(     BLK_SEL_1 ),
+            .RESET_MODE(    RESET_MODE ),
+            .INIT(          `BSRAM_INIT_VECTOR )
+        )
+        memory
+        (
+            .CLK(       { CLKB, CLKA } ),
+            .CE(        { CEB, CEA } ),
+            .OCE(       { OCE, 1'b0 } ),
+            .RESET(     { RESETB, RESETA } ),
+            .WRE(       { 1'b0, 1'b1 } ),
+            .BLKSEL(    { BLKSELB, BLKSELA } ),
+            .AD(        { ADB, ADA } ),
+            .DI(        { 32'd0, DI } ),
+            .DO(        w_DO )
+        );
+endmodule
+
+// dpb_simulation_wrapper - DPB, true dual port, 2 read / write ports of up to 16 bits
+//  A write on one port and an access to the same word on the other port in the same clock is undefined
+module dpb_simulation_wrapper
+    #(
+        parameter READ_MODE0    = 1'b0,
+        parameter READ_MODE1    = 1'b0,
+        parameter WRITE_MODE0   = 2'b00,
+        parameter WRITE_MODE1   = 2'b00,
+        parameter BIT_WIDTH_0   = 16,
+        parameter BIT_WIDTH_1   = 16,
+        parameter BLK_SEL_0     = 3'b000,
+        parameter BLK_SEL_1     = 3'b000,
+        `BSRAM_INIT_PARAMETERS
+        parameter RESET_MODE    = "SYNC"
+    )
+    (
+        output  wire    [15:0]  DOA,
+        output  wire    [15:0]  DOB,
+        input   wire    [15:0]  DIA,
+        input   wire    [15:0]  DIB,
+        input   wire    [2:0]   BLKSELA,
+        input   wire    [2:0]   BLKSELB,
+        input   wire    [13:0]  ADA,
+        input   wire    [13:0]  ADB,
+        input   wire            WREA,
+        input   wire            WREB,
+        input   wire            CLKA,
+        input   wire            CLKB,
+        input   wire            CEA,
+        input   wire            CEB,
+        input   wire            OCEA,
+        input   wire            OCEB,
+        input   wire            RESETA,
+        input   wire            RESETB
+    );
+    wire [63:0] w_DO;
+    assign DOA = w_DO[15:0];
+    assign DOB = w_DO[47:32];
+    bsram_simulation_model
+        #(
+            .READ_MODE0(    READ_MODE0 ),
+            .READ_MODE1(    READ_MODE1 ),
+            .WRITE_MODE0(   WRITE_MODE0 ),
+            .WRITE_MODE1(   WRITE_MODE1 ),
+            .BIT_WIDTH_0(   BIT_WIDTH_0 ),
+            .BIT_WIDTH_1(   BIT_WIDTH_1 ),
+            .BLK_SEL_0(     BLK_SEL_0 ),
+            .BLK_SEL_1(     BLK_SEL_1 ),
+            .RESET_MODE(    RESET_MODE ),
+            .INIT(          `BSRAM_INIT_VECTOR )
+        )
+        memory
+        (
+            .CLK(       { CLKB, CLKA } ),
+            .CE(        { CEB, CEA } ),
+            .OCE(       { OCEB, OCEA } ),
+            .RESET(     { RESETB, RESETA } ),
+            .WRE(       { WREB, WREA } ),
+            .BLKSEL(    { BLKSELB, BLKSELA } ),
+            .AD(        { ADB, ADA } ),
+            .DI(        { 16'd0, DIB, 16'd0, DIA } ),
+            .DO(        w_DO )
+        );
+endmodule
+
+// prom_simulation_wrapper - pROM, read only, the contents come from INIT_RAM_xx
+module prom_simulation_wrapper
+    #(
+        parameter READ_MODE     = 1'b0,
+        parameter BIT_WIDTH     = 32,
+        `BSRAM_INIT_PARAMETERS
+        parameter RESET_MODE    = "SYNC"
+    )
+    (
+        output  wire    [31:0]  DO,
+        input   wire    [13:0]  AD,
+        input   wire            CLK,
+        input   wire            CE,
+        input   wire            OCE,
+        input   wire            RESET
+    );
+    wire [63:0] w_DO;
+    assign DO = w_DO[31:0];
+    bsram_simulation_model
+        #(
+            .READ_MODE0(    READ_MODE ),
+            .BIT_WIDTH_0(   BIT_WIDTH ),
+            .RESET_MODE(    RESET_MODE ),
+            .INIT(          `BSRAM_INIT_VECTOR )
+        )
+        memory
+        (
+            .CLK(       { 1'b0, CLK } ),
+            .CE(        { 1'b0, CE } ),
+            .OCE(       { 1'b0, OCE } ),
+            .RESET(     { 1'b0, RESET } ),
+            .WRE(       2'b00 ),
+            .BLKSEL(    6'd0 ),
+            .AD(        { 14'd0, AD } ),
+            .DI(        64'd0 ),
+            .DO(        w_DO )
+        );
+endmodule
+
+// ram16_simulation_model - 16 x WIDTH shadow sram, synchronous write and asynchronous read.
+//  INIT bit ( n * 16 + word ) is bit n of 'word', the INIT_n parameters of the primitives
+module ram16_simulation_model
+    #(
+        parameter WIDTH = 4,
+        parameter INIT  = 64'h0
+    )
+    (
+        input   wire                CLK,
+        input   wire                WRE,
+        input   wire    [3:0]       WAD,
+        input   wire    [WIDTH-1:0] DI,
+        input   wire    [3:0]       RAD,
+        output  wire    [WIDTH-1:0] DO
+    );
+    reg [WIDTH*16-1:0] r_memory = INIT;
+    genvar idx;
+    generate
+        for( idx = 0; idx < WIDTH; idx = idx + 1 ) begin : ram16_bit_loop
+            assign DO[idx] = r_memory[idx*16+RAD];
+            always @( posedge CLK ) if( WRE ) r_memory[idx*16+WAD] <= DI[idx];
+        end
+    endgenerate
+endmodule
+
+// ram16s1_simulation_wrapper - RAM16S1, 16 x 1 shadow sram, 1 address
+module ram16s1_simulation_wrapper
+    #(
+        parameter INIT_0 = 16'h0000
+    )
+    (
+        output  wire            DO,
+        input   wire            DI,
+        input   wire    [3:0]   AD,
+        input   wire            WRE,
+        input   wire            CLK
+    );
+    ram16_simulation_model #( .WIDTH( 1 ), .INIT( { INIT_0 } ) ) memory
+    (
+        .CLK(   CLK ),
+        .WRE(   WRE ),
+        .WAD(   AD ),
+        .DI(    DI ),
+        .RAD(   AD ),
+        .DO(    DO )
+    );
+endmodule
+
+// ram16sdp1_simulation_wrapper - RAM16SDP1, 16 x 1 shadow sram, separate write and read addresses
+module ram16sdp1_simulation_wrapper
+    #(
+        parameter INIT_0 = 16'h0000
+    )
+    (
+        output  wire            DO,
+        input   wire            DI,
+        input   wire    [3:0]   WAD,
+        input   wire    [3:0]   RAD,
+        input   wire            WRE,
+        input   wire            CLK
+    );
+    ram16_simulation_model #( .WIDTH( 1 ), .INIT( { INIT_0 } ) ) memory
+    (
+        .CLK(   CLK ),
+        .WRE(   WRE ),
+        .WAD(   WAD ),
+        .DI(    DI ),
+        .RAD(   RAD ),
+        .DO(    DO )
+    );
+endmodule
+
+// ram16s2_simulation_wrapper - RAM16S2, 16 x 2 shadow sram, 1 address
+module ram16s2_simulation_wrapper
+    #(
+        parameter INIT_0 = 16'h0000,
+        parameter INIT_1 = 16'h0000
+    )
+    (
+        output  wire    [1:0]   DO,
+        input   wire    [1:0]   DI,
+        input   wire    [3:0]   AD,
+        input   wire            WRE,
+        input   wire            CLK
+    );
+    ram16_simulation_model #( .WIDTH( 2 ), .INIT( { INIT_1, INIT_0 } ) ) memory
+    (
+        .CLK(   CLK ),
+        .WRE(   WRE ),
+        .WAD(   AD ),
+        .DI(    DI ),
+        .RAD(   AD ),
+        .DO(    DO )
+    );
+endmodule
+
+// ram16sdp2_simulation_wrapper - RAM16SDP2, 16 x 2 shadow sram, separate write and read addresses
+module ram16sdp2_simulation_wrapper
+    #(
+        parameter INIT_0 = 16'h0000,
+        parameter INIT_1 = 16'h0000
+    )
+    (
+        output  wire    [1:0]   DO,
+        input   wire    [1:0]   DI,
+        input   wire    [3:0]   WAD,
+        input   wire    [3:0]   RAD,
+        input   wire            WRE,
+        input   wire            CLK
+    );
+    ram16_simulation_model #( .WIDTH( 2 ), .INIT( { INIT_1, INIT_0 } ) ) memory
+    (
+        .CLK(   CLK ),
+        .WRE(   WRE ),
+        .WAD(   WAD ),
+        .DI(    DI ),
+        .RAD(   RAD ),
+        .DO(    DO )
+    );
+endmodule
+
+// ram16s4_simulation_wrapper - RAM16S4, 16 x 4 shadow sram, 1 address
+module ram16s4_simulation_wrapper
+    #(
+        parameter INIT_0 = 16'h0000,
+        parameter INIT_1 = 16'h0000,
+        parameter INIT_2 = 16'h0000,
+        parameter INIT_3 = 16'h0000
+    )
+    (
+        output  wire    [3:0]   DO,
+        input   wire    [3:0]   DI,
+        input   wire    [3:0]   AD,
+        input   wire            WRE,
+        input   wire            CLK
+    );
+    ram16_simulation_model #( .WIDTH( 4 ), .INIT( { INIT_3, INIT_2, INIT_1, INIT_0 } ) ) memory
+    (
+        .CLK(   CLK ),
+        .WRE(   WRE ),
+        .WAD(   AD ),
+        .DI(    DI ),
+        .RAD(   AD ),
+        .DO(    DO )
+    );
+endmodule
+
+// ram16sdp4_simulation_wrapper - RAM16SDP4, 16 x 4 shadow sram, separate write and read addresses
+module ram16sdp4_simulation_wrapper
+    #(
+        parameter INIT_0 = 16'h0000,
+        parameter INIT_1 = 16'h0000,
+        parameter INIT_2 = 16'h0000,
+        parameter INIT_3 = 16'h0000
+    )
+    (
+        output  wire    [3:0]   DO,
+        input   wire    [3:0]   DI,
+        input   wire    [3:0]   WAD,
+        input   wire    [3:0]   RAD,
+        input   wire            WRE,
+        input   wire            CLK
+    );
+    ram16_simulation_model #( .WIDTH( 4 ), .INIT( { INIT_3, INIT_2, INIT_1, INIT_0 } ) ) memory
+    (
+        .CLK(   CLK ),
+        .WRE(   WRE ),
+        .WAD(   WAD ),
+        .DI(    DI ),
+        .RAD(   RAD ),
+        .DO(    DO )
+    );
+endmodule
+
+// the body of 'memory_pipelined' shared by each syn_ramstyle, only the attribute on r_memory differs
+`define MEMORY_PIPELINED_ARRAY \
+            initial if( INIT_FILE != "" ) $readmemh( INIT_FILE, r_memory ); \
+            for( idx = 0; idx < LANES; idx = idx + 1 ) begin : memory_lane_loop \
+                always @( posedge clk ) begin \
+                    if( write_enable[idx] ) \
+                        r_memory[write_address][idx*LANE_WIDTH+:LANE_WIDTH] <= write_data[idx*LANE_WIDTH+:LANE_WIDTH]; \
+                end \
+            end \
+            if( LATENCY == 0 ) begin \
+                assign w_read = r_memory[read_address]; \
+            end else begin \
+                reg [DATA_WIDTH-1:0] r_read = 0; \
+                always @( posedge clk ) r_read <= r_memory[read_address]; \
+                assign w_read = r_read; \
+            end
+
+// memory_pipelined - simple dual port memory, 1 write and 1 read per clock
+//  STYLE           - inferred through syn_ramstyle, "block_ram" for BSRAM, "distributed_ram" for the shadow sram, "registers"
+//                    or instantiated through the *_PRIMITIVE defines
+//                      "SDPB"      - SDPB blocks, the widest aspect ratio that holds DEPTH words, DEPTH MUST BE <= 16384.
+//                                    Data wider than the aspect ratio is split into columns of blocks.
+//                      "RAM16SDP"  - RAM16SDP4 shadow srams, 4 bit columns and 16 word rows, the read is muxed by row.
+//                    INIT_FILE is ignored by the primitive styles.
+//  BYTE_ENABLES    - 1: write_enable has a bit per 8 bits of data, DATA_WIDTH MUST BE a multiple of 8
+//                    0: write_enable[0] writes the whole word
+//  LATENCY         - read_data is valid exactly 'LATENCY' clocks after read_address. The first register is
+//                    the read register of the BSRAM, the second can be taken as its pipeline register, the
+//                    rest are placed after the memory. LATENCY 0 is an asynchronous read, not for "block_ram" or "SDPB"
+//  INIT_FILE       - optional $readmemh file with the initial contents
+// A read of the word being written on the same clock returns the old word.
+module memory_pipelined
+    #(
+        parameter DATA_WIDTH    = 32,
+        parameter DEPTH         = 512,
+        parameter ADDRESS_WIDTH = 9,
+        parameter BYTE_ENABLES  = 0,
+        parameter LATENCY       = 1,
+        parameter STYLE         = "block_ram",
+        parameter INIT_FILE     = ""
+    )
+    (
+        input   wire                                                clk,
+        input   wire    [( BYTE_ENABLES ? DATA_WIDTH / 8 : 1 )-1:0] write_enable,
+        input   wire    [ADDRESS_WIDTH-1:0]                         write_address,
+        input   wire    [DATA_WIDTH-1:0]                            write_data,
+        input   wire    [ADDRESS_WIDTH-1:0]                         read_address,
+        output  wire    [DATA_WIDTH-1:0]                            read_data
+    );
+    localparam LANES            = BYTE_ENABLES ? DATA_WIDTH / 8 : 1;
+    localparam LANE_WIDTH       = DATA_WIDTH / LANES;
+    // SDPB takes the second register as its pipeline register, READ_MODE 1
+    localparam READ_REGISTERS   = STYLE == "SDPB" && LATENCY >= 2 ? 2 : 1;
+
+    // the memory read, after READ_REGISTERS registers, before the output pipeline
+    wire [DATA_WIDTH-1:0] w_read;
+
+    genvar idx;
+    generate
+        if( STYLE == "block_ram" ) begin
+            (* syn_ramstyle = "block_ram" *) reg [DATA_WIDTH-1:0] r_memory [0:DEPTH-1];
+            `MEMORY_PIPELINED_ARRAY
+        end else if( STYLE == "distributed_ram" ) begin
+            (* syn_ramstyle = "distributed_ram" *) reg [DATA_WIDTH-1:0] r_memory [0:DEPTH-1];
+            `MEMORY_PIPELINED_ARRAY
+        end else if( STYLE == "SDPB" ) begin
+            localparam BLOCK_WIDTH  = DEPTH <= 512 ? 32 : DEPTH <= 1024 ? 16 : DEPTH <= 2048 ? 8 : DEPTH <= 4096 ? 4 : DEPTH <= 8192 ? 2 : 1;
+            localparam BLOCK_LSB    = BLOCK_WIDTH == 32 ? 5 : BLOCK_WIDTH == 16 ? 4 : BLOCK_WIDTH == 8 ? 3 : BLOCK_WIDTH == 4 ? 2 : BLOCK_WIDTH == 2 ? 1 : 0;
+            localparam COLUMNS      = ( DATA_WIDTH + BLOCK_WIDTH - 1 ) / BLOCK_WIDTH;
+            wire [COLUMNS*BLOCK_WIDTH-1:0]  w_write_data    = write_data;
+            wire [COLUMNS*4-1:0]            w_enables       = write_enable;
+            wire [COLUMNS*BLOCK_WIDTH-1:0]  w_columns;
+            for( idx = 0; idx < COLUMNS; idx = idx + 1 ) begin : sdpb_column_loop
+                // port A writes, AD[3:0] are the byte enables of the 32 bit and AD[1:0] of the 16 bit aspect ratio
+                wire        w_write;
+                wire [3:0]  w_bytes;
+                if( BYTE_ENABLES == 0 ) begin
+                    assign w_write  = write_enable[0];
+                    assign w_bytes  = 4'b1111;
+                end else if( BLOCK_WIDTH >= 16 ) begin
+                    assign w_bytes  = w_enables[idx*(BLOCK_WIDTH/8)+:BLOCK_WIDTH/8];
+                    assign w_write  = |w_bytes;
+                end else begin
+                    assign w_write  = write_enable[idx*BLOCK_WIDTH/8];
+                    assign w_bytes  = 4'b1111;
+                end
+                wire [13:0] w_write_ad  = ( write_address << BLOCK_LSB ) | ( BLOCK_WIDTH == 32 ? w_bytes : BLOCK_WIDTH == 16 ? w_bytes[1:0] : 2'b00 );
+                wire [13:0] w_read_ad   = read_address << BLOCK_LSB;
+                wire [31:0] w_DI        = w_write_data[idx*BLOCK_WIDTH+:BLOCK_WIDTH];
+                wire [31:0] w_DO;
+                `SDPB_PRIMITIVE block( .DO(         w_DO ),
+                                       .DI(         w_DI ),
+                                       .BLKSELA(    3'b000 ),
+                                       .BLKSELB(    3'b000 ),
+                                       .ADA(        w_write_ad ),
+                                       .ADB(        w_read_ad ),
+                                       .CLKA(       clk ),
+                                       .CLKB(       clk ),
+                                       .CEA(        w_write ),
+                                       .CEB(        1'b1 ),
+                                       .OCE(        1'b1 ),
+                                       .RESETA(     1'b0 ),
+                                       .RESETB(     1'b0 )
+                                     );
+                                     defparam block.READ_MODE   = READ_REGISTERS == 2 ? 1'b1 : 1'b0;
+                                     defparam block.BIT_WIDTH_0 = BLOCK_WIDTH;
+                                     defparam block.BIT_WIDTH_1 = BLOCK_WIDTH;
+                assign w_columns[idx*BLOCK_WIDTH+:BLOCK_WIDTH] = w_DO[BLOCK_WIDTH-1:0];
+            end
+            assign w_read = w_columns[DATA_WIDTH-1:0];
+        end else if( STYLE == "RAM16SDP" ) begin
+            localparam ROWS     = ( DEPTH + 15 ) / 16;
+            localparam COLUMNS  = ( DATA_WIDTH + 3 ) / 4;
+            wire [COLUMNS*4-1:0]        w_write_data    = write_data;
+            wire [ROWS*COLUMNS*4-1:0]   w_rows;
+            genvar row;
+            for( row = 0; row < ROWS; row = row + 1 ) begin : ram16_row_loop
+                for( idx = 0; idx < COLUMNS; idx = idx + 1 ) begin : ram16_column_loop
+                    wire w_write = write_enable[BYTE_ENABLES ? idx / 2 : 0] && ( write_address >> 4 ) == row;
+                    `RAM16SDP4_PRIMITIVE memory( .DO(   w_rows[(row*COLUMNS+idx)*4+:4] ),
+                                                 .DI(   w_write_data[idx*4+:4] ),
+                                                 .WAD(  write_address[3:0] ),
+                                                 .RAD(  read_address[3:0] ),
+                                                 .WRE(  w_write ),
+                                                 .CLK(  clk )
+                                               );
+                end
+            end
+            wire [COLUMNS*4-1:0] w_row_read = w_rows[( read_address >> 4 )*COLUMNS*4+:COLUMNS*4];
+            if( LATENCY == 0 ) begin
+                assign w_read = w_row_read[DATA_WIDTH-1:0];
+            end else begin
+                reg [DATA_WIDTH-1:0] r_read = 0;
+                always @( posedge clk ) r_read <= w_row_read[DATA_WIDTH-1:0];
+                assign w_read = r_read;
+            end
+        end else begin
+            (* syn_ramstyle = "registers" *) reg [DATA_WIDTH-1:0] r_memory [0:DEPTH-1];
+            `MEMORY_PIPELINED_ARRAY
+        end
+        if( LATENCY == 0 ) begin
+            assign read_data = w_read;
+        end else begin
+            ff_delay #( .WIDTH( DATA_WIDTH ), .DEPTH( LATENCY - READ_REGISTERS ) ) read_delay ( .clk( clk ), .D( w_read ), .Q( read_data ) );
+        end
+    endgenerate
+endmodule
+`undef MEMORY_PIPELINED_ARRAY
@@ -0,0 +1,489 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	cache.v
+//
+// Project:	cache
+//
+// Purpose:	Set associative cache with hit under miss between a word request
+//          port and a burst memory port such as 'hyperram_controller'.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// cache - WAYS way set associative, 1 way is direct mapped
+//  The word address is { tag, set, word }, a line is 2 ** LINE_WIDTH words and there are 2 ** SET_WIDTH sets.
+//  req_*       a read or write of 1 word, taken on the clock req_valid and req_ready are set. Writes are
+//              posted, reads answer on resp_* with their req_id. A hit answers LOOKUP_LATENCY + 1 clocks
+//              after the request, hits keep answering while a miss is being filled, so answers can
+//              leave out of order.
+//  mem_*       the burst memory, the same ports as 'hyperram_controller', tie its cmd_register to 0 and
+//              its wr_strobe to 2'b11. Commands are whole lines, cmd_length = 2 ** LINE_WIDTH - 1, and
+//              in write through mode single words. The memory MUST return read words in order.
+//  WRITE_BACK  1: write back, write allocate, dirty lines are written back when they are replaced
+//              0: write through, no write allocate
+//  hit_count / miss_count count every request once, a request that missed is not counted as a hit
+//  when it is replayed.
+//
+// The tags, with a valid and a dirty bit, and the data live in block ram, 1 memory_pipelined per way.
+//  clock 0                     the tags and data of the set are read, from the request, a replay or a
+//                              line being written back
+//  clock 1 .. LOOKUP_LATENCY   the tag of every way is compared with math_pipelined_reduce "AND" over
+//                              { valid, ~( tag ^ request tag ) }, the 'cmp_eq' tree of math_pipelined
+//  clock LOOKUP_LATENCY        hit, miss or replay
+// A request whose tags or word were written while it was in the pipeline, whose set is being
+// filled, or that follows a replayed request to the same set, is replayed, it enters the pipeline
+// again through a replay queue that goes before new requests, so requests to a set stay in order.
+// A miss starts the single line fill when it is free and is replayed until it hits, so requests to
+// the other sets that hit keep going while the line is filled.
+// The tags are cleared for 2 ** SET_WIDTH clocks after rst, req_ready is low.
+// LINE_WIDTH >= 1, LOOKUP_LATENCY = COMPARE_LATENCY + 1
+module cache
+    #(
+        parameter ADDRESS_WIDTH     = 22,
+        parameter DATA_WIDTH        = 16,
+        parameter ID_WIDTH          = 4,
+        parameter LINE_WIDTH        = 3,
+        parameter SET_WIDTH         = 7,
+        parameter WAYS              = 2,
+        parameter WRITE_BACK        = 1,
+        parameter COMPARE_LATENCY   = 1,
+        parameter LENGTH_WIDTH      = 7,
+        parameter COUNTER_WIDTH     = 32
+    )
+    (
+        input   wire                        clk,
+        input   wire                        rst,
+        // requests
+        input   wire                        req_valid,
+        output  wire                        req_ready,
+        input   wire                        req_write,
+        input   wire    [ADDRESS_WIDTH-1:0] req_address,
+        input   wire    [DATA_WIDTH-1:0]    req_data,
+        input   wire    [ID_WIDTH-1:0]      req_id,
+        output  wire                        resp_valid,
+        output  wire    [ID_WIDTH-1:0]      resp_id,
+        output  wire    [DATA_WIDTH-1:0]    resp_data,
+        // burst memory
+        output  wire                        mem_cmd_valid,
+        input   wire                        mem_cmd_ready,
+        output  wire                        mem_cmd_write,
+        output  wire    [ADDRESS_WIDTH-1:0] mem_cmd_address,
+        output  wire    [LENGTH_WIDTH-1:0]  mem_cmd_length,
+        output  wire                        mem_wr_valid,
+        input   wire                        mem_wr_ready,
+        output  wire    [DATA_WIDTH-1:0]    mem_wr_data,
+        input   wire                        mem_rd_valid,
+        input   wire    [DATA_WIDTH-1:0]    mem_rd_data,
+        // instrumentation
+        output  wire    [COUNTER_WIDTH-1:0] hit_count,
+        output  wire    [COUNTER_WIDTH-1:0] miss_count
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    localparam LINE_WORDS       = 1 << LINE_WIDTH;
+    localparam SETS             = 1 << SET_WIDTH;
+    localparam TAG_WIDTH        = ADDRESS_WIDTH - SET_WIDTH - LINE_WIDTH;
+    localparam TAG_ENTRY        = TAG_WIDTH + 2;                                // { valid, dirty, tag }
+    localparam WAY_WIDTH        = f_Log2( WAYS );
+    localparam LOOKUP_LATENCY   = COMPARE_LATENCY + 1;
+    localparam ENTRY_WIDTH      = 2 + ADDRESS_WIDTH + DATA_WIDTH + ID_WIDTH;    // { write, missed, address, data, id }
+    localparam REPLAY_WIDTH     = f_Log2( LOOKUP_LATENCY + 1 );
+
+    localparam FILL_INIT        = 0;
+    localparam FILL_IDLE        = 1;
+    localparam FILL_EVICT       = 2;
+    localparam FILL_WRITE_BACK  = 3;
+    localparam FILL_READ        = 4;
+    localparam FILL_REFILL      = 5;
+
+    // line fill
+    reg  [2:0]                  r_fill_state    = FILL_INIT;
+    reg  [SET_WIDTH+LINE_WIDTH:0] r_fill_count  = 0;
+    reg  [SET_WIDTH-1:0]        r_fill_set      = 0;
+    reg  [TAG_WIDTH-1:0]        r_fill_tag      = 0;
+    reg  [TAG_WIDTH-1:0]        r_fill_victim   = 0;    // the tag written back
+    reg  [WAY_WIDTH-1:0]        r_fill_way      = 0;
+    reg  [WAYS-1:0]             r_next_victim   = 1;    // round robin replacement
+
+    ////////////////////
+    // clock 0, issue //
+    ////////////////////
+    wire                        w_replay_valid;
+    wire [ENTRY_WIDTH-1:0]      w_replay_entry;
+    wire                        w_issue_evict   = r_fill_state == FILL_EVICT;
+    wire                        w_issue_replay  = !w_issue_evict && w_replay_valid;
+    assign req_ready = r_fill_state != FILL_INIT && !w_issue_evict && !w_replay_valid;
+    wire                        w_issue_valid   = w_issue_replay || ( req_valid && req_ready );
+    wire [ENTRY_WIDTH-1:0]      w_issue_entry   = w_issue_replay ? w_replay_entry : { req_write, 1'b0, req_address, req_data, req_id };
+    wire [ADDRESS_WIDTH-1:0]    w_issue_address = w_issue_entry[DATA_WIDTH+ID_WIDTH+:ADDRESS_WIDTH];
+    wire [SET_WIDTH-1:0]        w_read_set      = w_issue_evict ? r_fill_set : w_issue_address[LINE_WIDTH+:SET_WIDTH];
+    wire [LINE_WIDTH-1:0]       w_read_word     = w_issue_evict ? r_fill_count[LINE_WIDTH-1:0] : w_issue_address[LINE_WIDTH-1:0];
+
+    // the entry through the pipeline
+    reg  [LOOKUP_LATENCY-1:0]   r_valid = 0;
+    reg  [LOOKUP_LATENCY-1:0]   r_evict = 0;
+    wire [ENTRY_WIDTH-1:0]      w_compare_entry;
+    wire [ENTRY_WIDTH-1:0]      w_decide_entry;
+    always @( posedge clk ) begin
+        if( rst ) begin
+            r_valid <= 'd0;
+            r_evict <= 'd0;
+        end else begin
+            r_valid <= ( r_valid << 1 ) | w_issue_valid;
+            r_evict <= ( r_evict << 1 ) | w_issue_evict;
+        end
+    end
+    ff_delay #( .WIDTH( ENTRY_WIDTH ), .DEPTH( 1 ) ) compare_delay ( .clk( clk ), .D( w_issue_entry ), .Q( w_compare_entry ) );
+    ff_delay #( .WIDTH( ENTRY_WIDTH ), .DEPTH( COMPARE_LATENCY ) ) decide_delay ( .clk( clk ), .D( w_compare_entry ), .Q( w_decide_entry ) );
+    wire [TAG_WIDTH-1:0]        w_compare_tag   = w_compare_entry[DATA_WIDTH+ID_WIDTH+LINE_WIDTH+SET_WIDTH+:TAG_WIDTH];
+
+    // tag and data memories, the write ports are shared by the ways
+    reg                         w_tag_write;
+    reg  [WAYS-1:0]             w_tag_ways;
+    reg  [SET_WIDTH-1:0]        w_tag_set;
+    reg  [TAG_ENTRY-1:0]        w_tag_data;
+    reg                         w_data_write;
+    reg  [WAYS-1:0]             w_data_ways;
+    reg  [SET_WIDTH+LINE_WIDTH-1:0] w_data_address;
+    reg  [DATA_WIDTH-1:0]       w_data_data;
+    wire [WAYS*TAG_ENTRY-1:0]   w_tag_read;
+    wire [WAYS*DATA_WIDTH-1:0]  w_data_read;
+    wire [WAYS*TAG_ENTRY-1:0]   w_decide_tags;
+    wire [WAYS*DATA_WIDTH-1:0]  w_decide_data;
+    wire [WAYS-1:0]             w_decide_hits;
+    genvar way;
+    generate
+        for( way = 0; way < WAYS; way = way + 1 ) begin : cache_way_loop
+            memory_pipelined #( .DATA_WIDTH( TAG_ENTRY ), .DEPTH( SETS ), .ADDRESS_WIDTH( SET_WIDTH ), .LATENCY( 1 ), .STYLE( "block_ram" ) ) tag_memory
+            (
+                .clk(           clk ),
+                .write_enable(  w_tag_write && w_tag_ways[way] ),
+                .write_address( w_tag_set ),
+                .write_data(    w_tag_data ),
+                .read_address(  w_read_set ),
+                .read_data(     w_tag_read[way*TAG_ENTRY+:TAG_ENTRY] )
+            );
+            memory_pipelined #( .DATA_WIDTH( DATA_WIDTH ), .DEPTH( SETS * LINE_WORDS ), .ADDRESS_WIDTH( SET_WIDTH + LINE_WIDTH ), .LATENCY( 1 ), .STYLE( "block_ram" ) ) data_memory
+            (
+                .clk(           clk ),
+                .write_enable(  w_data_write && w_data_ways[way] ),
+                .write_address( w_data_address ),
+                .write_data(    w_data_data ),
+                .read_address(  { w_read_set, w_read_word } ),
+                .read_data(     w_data_read[way*DATA_WIDTH+:DATA_WIDTH] )
+            );
+            // tag compare, { valid, ~( tag ^ request tag ) } reduced with AND
+            math_pipelined_reduce #( .WIDTH( TAG_WIDTH + 1 ), .LATENCY( COMPARE_LATENCY ), .OPERATION( "AND" ) ) tag_compare
+            (
+                .clk(       clk ),
+                .I1(        { w_tag_read[way*TAG_ENTRY+TAG_ENTRY-1], ~( w_tag_read[way*TAG_ENTRY+:TAG_WIDTH] ^ w_compare_tag ) } ),
+                .result(    w_decide_hits[way] )
+            );
+        end
+    endgenerate
+    ff_delay #( .WIDTH( WAYS * ( TAG_ENTRY + DATA_WIDTH ) ), .DEPTH( COMPARE_LATENCY ) ) read_delay
+    (
+        .clk(   clk ),
+        .D(     { w_tag_read, w_data_read } ),
+        .Q(     { w_decide_tags, w_decide_data } )
+    );
+
+    ////////////////////////////////////
+    // clock LOOKUP_LATENCY, decision //
+    ////////////////////////////////////
+    wire                        w_decide_valid  = r_valid[LOOKUP_LATENCY-1];
+    wire                        w_decide_evict  = r_evict[LOOKUP_LATENCY-1];
+    wire                        w_decide_write  = w_decide_entry[ENTRY_WIDTH-1];
+    wire                        w_decide_missed = w_decide_entry[ENTRY_WIDTH-2];
+    wire [ADDRESS_WIDTH-1:0]    w_decide_address= w_decide_entry[DATA_WIDTH+ID_WIDTH+:ADDRESS_WIDTH];
+    wire [DATA_WIDTH-1:0]       w_decide_data_in= w_decide_entry[ID_WIDTH+:DATA_WIDTH];
+    wire [ID_WIDTH-1:0]         w_decide_id     = w_decide_entry[ID_WIDTH-1:0];
+    wire [SET_WIDTH-1:0]        w_decide_set    = w_decide_address[LINE_WIDTH+:SET_WIDTH];
+    wire [TAG_WIDTH-1:0]        w_decide_tag    = w_decide_address[ADDRESS_WIDTH-1-:TAG_WIDTH];
+
+    // the tag and data writes of the last LOOKUP_LATENCY clocks, newest first, that the reads missed
+    reg  [LOOKUP_LATENCY-1:0]               r_tag_history_valid     = 0;
+    reg  [LOOKUP_LATENCY*SET_WIDTH-1:0]     r_tag_history_set       = 0;
+    reg  [LOOKUP_LATENCY-1:0]               r_data_history_valid    = 0;
+    reg  [LOOKUP_LATENCY*ADDRESS_WIDTH-1:0] r_data_history_address  = 0;
+    // the sets replayed in the last LOOKUP_LATENCY clocks, younger requests to them follow into the replay queue
+    reg  [LOOKUP_LATENCY-1:0]               r_replay_history_valid  = 0;
+    reg  [LOOKUP_LATENCY*SET_WIDTH-1:0]     r_replay_history_set    = 0;
+
+    // the line fill's own memory traffic
+    wire w_refill_write = r_fill_state == FILL_REFILL && mem_rd_valid;
+    wire w_refill_done  = w_refill_write && r_fill_count == LINE_WORDS - 1;
+    wire w_fill_command = r_fill_state == FILL_WRITE_BACK || r_fill_state == FILL_READ;
+    wire w_fill_busy    = r_fill_state != FILL_IDLE && r_fill_state != FILL_INIT;
+    wire w_evict_empty;
+
+    reg                         w_conflict;
+    reg                         w_hit;
+    reg  [WAY_WIDTH-1:0]        w_hit_way;
+    reg                         w_hit_dirty;
+    reg  [DATA_WIDTH-1:0]       w_hit_data;
+    reg                         w_has_invalid;
+    reg  [WAY_WIDTH-1:0]        w_invalid_way;
+    reg  [WAY_WIDTH-1:0]        w_victim_way;
+    reg  [TAG_ENTRY-1:0]        w_victim;
+    reg                         w_replay;
+    reg                         w_respond;
+    reg                         w_fill_start;
+    reg                         w_through;
+    reg                         w_count_hit;
+    reg                         w_count_miss;
+    integer idx;
+    always @(*) begin
+        // a tag or word written since the memories were read, or the set being filled
+        w_conflict = w_fill_busy && w_decide_set == r_fill_set;
+        for( idx = 0; idx < LOOKUP_LATENCY; idx = idx + 1 ) begin
+            if( r_tag_history_valid[idx] && r_tag_history_set[idx*SET_WIDTH+:SET_WIDTH] == w_decide_set )
+                w_conflict = 1'b1;
+            if( r_data_history_valid[idx] && r_data_history_address[idx*ADDRESS_WIDTH+:ADDRESS_WIDTH] == w_decide_address )
+                w_conflict = 1'b1;
+            if( r_replay_history_valid[idx] && r_replay_history_set[idx*SET_WIDTH+:SET_WIDTH] == w_decide_set )
+                w_conflict = 1'b1;
+        end
+        // the hit way, and the way to replace, the first invalid way or round robin
+        w_hit           = |w_decide_hits;
+        w_hit_way       = 'd0;
+        w_has_invalid   = 1'b0;
+        w_invalid_way   = 'd0;
+        w_victim_way    = 'd0;
+        for( idx = WAYS - 1; idx >= 0; idx = idx - 1 ) begin
+            if( w_decide_hits[idx] )
+                w_hit_way = idx;
+            if( !w_decide_tags[idx*TAG_ENTRY+TAG_ENTRY-1] ) begin
+                w_has_invalid   = 1'b1;
+                w_invalid_way   = idx;
+            end
+            if( r_next_victim[idx] )
+                w_victim_way = idx;
+        end
+        if( w_has_invalid )
+            w_victim_way = w_invalid_way;
+        w_hit_dirty = w_decide_tags[w_hit_way*TAG_ENTRY+TAG_WIDTH];
+        w_hit_data  = w_decide_data[w_hit_way*DATA_WIDTH+:DATA_WIDTH];
+        w_victim    = w_decide_tags[w_victim_way*TAG_ENTRY+:TAG_ENTRY];
+
+        w_tag_write     = 1'b0;
+        w_tag_ways      = 'd0;
+        w_tag_set       = w_decide_set;
+        w_tag_data      = 'd0;
+        w_data_write    = 1'b0;
+        w_data_ways     = 'd0;
+        w_data_address  = w_decide_address[SET_WIDTH+LINE_WIDTH-1:0];
+        w_data_data     = w_decide_data_in;
+        w_replay        = 1'b0;
+        w_respond       = 1'b0;
+        w_fill_start    = 1'b0;
+        w_through       = 1'b0;
+        w_count_hit     = 1'b0;
+        w_count_miss    = 1'b0;
+        if( w_decide_valid ) begin
+            if( w_conflict ) begin
+                w_replay = 1'b1;
+            end else if( w_hit && !w_decide_write ) begin
+                w_respond   = 1'b1;
+                w_count_hit = !w_decide_missed;
+            end else if( w_hit ) begin
+                if( w_refill_write || ( WRITE_BACK && !w_hit_dirty && w_refill_done )
+                 || ( !WRITE_BACK && ( w_fill_command || !mem_cmd_ready || !mem_wr_ready ) ) ) begin
+                    // a write port is taken by the line fill
+                    w_replay = 1'b1;
+                end else begin
+                    w_data_write    = 1'b1;
+                    w_data_ways[w_hit_way] = 1'b1;
+                    w_tag_write     = WRITE_BACK && !w_hit_dirty;
+                    w_tag_ways[w_hit_way] = 1'b1;
+                    w_tag_data      = { 2'b11, w_decide_tag };
+                    w_through       = !WRITE_BACK;
+                    w_count_hit     = !w_decide_missed;
+                end
+            end else if( !WRITE_BACK && w_decide_write ) begin
+                // no write allocate
+                w_count_miss = !w_decide_missed;
+                if( w_fill_command || !mem_cmd_ready || !mem_wr_ready )
+                    w_replay    = 1'b1;
+                else
+                    w_through   = 1'b1;
+            end else begin
+                w_count_miss    = !w_decide_missed;
+                w_replay        = 1'b1;
+                if( !w_fill_busy && w_evict_empty ) begin
+                    // invalidate the victim and fill the line
+                    w_fill_start    = 1'b1;
+                    w_tag_write     = 1'b1;
+                    w_tag_ways[w_victim_way] = 1'b1;
+                    w_tag_data      = 'd0;
+                end
+            end
+        end
+        // the line fill owns the write ports when it needs them
+        if( w_refill_write ) begin
+            w_data_write    = 1'b1;
+            w_data_ways     = 'd0;
+            w_data_ways[r_fill_way] = 1'b1;
+            w_data_address  = { r_fill_set, r_fill_count[LINE_WIDTH-1:0] };
+            w_data_data     = mem_rd_data;
+        end
+        if( w_refill_done ) begin
+            w_tag_write     = 1'b1;
+            w_tag_ways      = 'd0;
+            w_tag_ways[r_fill_way] = 1'b1;
+            w_tag_set       = r_fill_set;
+            w_tag_data      = { 2'b10, r_fill_tag };
+        end
+        if( r_fill_state == FILL_INIT ) begin
+            w_tag_write     = 1'b1;
+            w_tag_ways      = { WAYS{1'b1} };
+            w_tag_set       = r_fill_count[SET_WIDTH-1:0];
+            w_tag_data      = 'd0;
+        end
+    end
+
+    // replay queue, holds at most the LOOKUP_LATENCY + 1 requests in the pipeline
+    fifo_sync #( .WIDTH( ENTRY_WIDTH ), .ADDRESS_WIDTH( REPLAY_WIDTH ) ) replay_queue
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  w_replay ),
+        .in_ready(),
+        .in_data(   { w_decide_write, w_decide_missed || w_count_miss, w_decide_address, w_decide_data_in, w_decide_id } ),
+        .out_valid( w_replay_valid ),
+        .out_ready( w_issue_replay ),
+        .out_data(  w_replay_entry ),
+        .count()
+    );
+
+    reg                         r_resp_valid    = 0;
+    reg  [ID_WIDTH-1:0]         r_resp_id       = 0;
+    reg  [DATA_WIDTH-1:0]       r_resp_data     = 0;
+    reg  [COUNTER_WIDTH-1:0]    r_hit_count     = 0;
+    reg  [COUNTER_WIDTH-1:0]    r_miss_count    = 0;
+    assign resp_valid   = r_resp_valid;
+    assign resp_id      = r_resp_id;
+    assign resp_data    = r_resp_data;
+    assign hit_count    = r_hit_count;
+    assign miss_count   = r_miss_count;
+
+    always @( posedge clk ) begin
+        r_resp_valid            <= w_respond;
+        r_resp_id               <= w_decide_id;
+        r_resp_data             <= w_hit_data;
+        r_tag_history_valid     <= ( r_tag_history_valid << 1 ) | w_tag_write;
+        r_tag_history_set       <= ( r_tag_history_set << SET_WIDTH ) | w_tag_set;
+        r_data_history_valid    <= ( r_data_history_valid << 1 ) | ( w_data_write && !w_refill_write );
+        r_data_history_address  <= ( r_data_history_address << ADDRESS_WIDTH ) | w_decide_address;
+        r_replay_history_valid  <= ( r_replay_history_valid << 1 ) | w_replay;
+        r_replay_history_set    <= ( r_replay_history_set << SET_WIDTH ) | w_decide_set;
+        r_hit_count             <= r_hit_count + w_count_hit;
+        r_miss_count            <= r_miss_count + w_count_miss;
+
+        case( r_fill_state )
+            FILL_INIT: begin
+                r_fill_count <= r_fill_count + 1'b1;
+                if( r_fill_count == SETS - 1 )
+                    r_fill_state <= FILL_IDLE;
+            end
+            FILL_IDLE: begin
+                if( w_fill_start ) begin
+                    r_fill_set      <= w_decide_set;
+                    r_fill_tag      <= w_decide_tag;
+                    r_fill_victim   <= w_victim[TAG_WIDTH-1:0];
+                    r_fill_way      <= w_victim_way;
+                    r_fill_count    <= 'd0;
+                    if( !w_has_invalid )
+                        r_next_victim <= { r_next_victim, r_next_victim[WAYS-1] };  // rotate
+                    r_fill_state    <= WRITE_BACK && w_victim[TAG_ENTRY-1] && w_victim[TAG_WIDTH] ? FILL_EVICT : FILL_READ;
+                end
+            end
+            FILL_EVICT: begin
+                // 1 word of the victim is read per clock, see w_issue_evict
+                r_fill_count <= r_fill_count + 1'b1;
+                if( r_fill_count == LINE_WORDS - 1 )
+                    r_fill_state <= FILL_WRITE_BACK;
+            end
+            FILL_WRITE_BACK: begin
+                if( mem_cmd_ready )
+                    r_fill_state <= FILL_READ;
+            end
+            FILL_READ: begin
+                r_fill_count <= 'd0;
+                if( mem_cmd_ready )
+                    r_fill_state <= FILL_REFILL;
+            end
+            FILL_REFILL: begin
+                if( mem_rd_valid ) begin
+                    r_fill_count <= r_fill_count + 1'b1;
+                    if( w_refill_done )
+                        r_fill_state <= FILL_IDLE;
+                end
+            end
+            default: r_fill_state <= FILL_IDLE;
+        endcase
+        if( rst ) begin
+            r_resp_valid            <= 1'b0;
+            r_tag_history_valid     <= 'd0;
+            r_data_history_valid    <= 'd0;
+            r_replay_history_valid  <= 'd0;
+            r_hit_count             <= 'd0;
+            r_miss_count            <= 'd0;
+            r_fill_state            <= FILL_INIT;
+            r_fill_count            <= 'd0;
+            r_next_victim           <= 1;
+        end
+    end
+
+    // memory commands, the line fill goes first
+    wire [ADDRESS_WIDTH-1:0] w_fill_address = { r_fill_state == FILL_WRITE_BACK ? r_fill_victim : r_fill_tag, r_fill_set, { LINE_WIDTH{1'b0} } };
+    assign mem_cmd_valid    = w_fill_command || w_through;
+    assign mem_cmd_write    = w_fill_command ? r_fill_state == FILL_WRITE_BACK : 1'b1;
+    assign mem_cmd_address  = w_fill_command ? w_fill_address : w_decide_address;
+    assign mem_cmd_length   = w_fill_command ? LINE_WORDS - 1 : 'd0;
+
+    generate
+        if( WRITE_BACK ) begin
+            // the victim words wait here until the memory takes them
+            fifo_sync #( .WIDTH( DATA_WIDTH ), .ADDRESS_WIDTH( LINE_WIDTH ) ) evict_buffer
+            (
+                .clk(       clk ),
+                .rst(       rst ),
+                .in_valid(  w_decide_evict ),
+                .in_ready(),
+                .in_data(   w_decide_data[r_fill_way*DATA_WIDTH+:DATA_WIDTH] ),
+                .out_valid( mem_wr_valid ),
+                .out_ready( mem_wr_ready ),
+                .out_data(  mem_wr_data ),
+                .count()
+            );
+            assign w_evict_empty = !mem_wr_valid;
+        end else begin
+            assign mem_wr_valid     = w_through;
+            assign mem_wr_data      = w_decide_data_in;
+            assign w_evict_empty    = 1'b1;
+        end
+    endgenerate
+endmodule
@@ -0,0 +1,378 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	cache_tb.v
+//
+// Project:	cache
+//
+// Purpose:	Test bench for cache on hyperram_controller and hyperram_simulation_model.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// cache_tb - a small cache, 4 sets of 2 ways of 4 word lines, on hyperram_controller and a
+//  hyperram_simulation_model that doubles the latency every REFRESH_EVERY transactions.
+//  1   a line written and read back in every set
+//  2   a miss followed by reads and a write that hit other sets, the hits answer first
+//  3   4 lines written to 1 set and read back, the lines are replaced while dirty
+//  4   random reads and writes over 8 tags of every set
+//  5   reads of 4 unused tags in every set, which replaces every line the tests left in the cache
+//  Every answer is compared, by req_id, with a reference memory as it was when the read was requested,
+//  then the model's memory is compared with it word by word. The bench also checks that:
+//  - answers left out of order, hits under a miss;
+//  - WRITE_BACK 1 wrote back whole dirty lines and no single words;
+//  - WRITE_BACK 0 wrote every write through as a single word and no lines;
+//  - hit_count + miss_count is the number of requests.
+//  test_benches.sh runs it with both WRITE_BACK settings.
+module cache_tb
+    #(
+        parameter WRITE_BACK    = 1,
+        parameter LATENCY       = 3,
+        parameter REFRESH_EVERY = 3
+    );
+    localparam ADDRESS_WIDTH    = 10;
+    localparam LINE_WIDTH       = 2;
+    localparam SET_WIDTH        = 2;
+    localparam ID_WIDTH         = 4;
+    localparam DEPTH            = 1 << ADDRESS_WIDTH;
+    localparam IDS              = 1 << ID_WIDTH;
+    localparam LINE_WORDS       = 1 << LINE_WIDTH;
+    localparam SETS             = 1 << SET_WIDTH;
+    localparam BENCH            = "cache_tb";
+    localparam TIMEOUT          = 5000000;
+
+    reg clk = 0;
+    always #5 clk = !clk;
+    reg rst = 1;
+
+    reg                         req_valid       = 0;
+    wire                        req_ready;
+    reg                         req_write       = 0;
+    reg  [ADDRESS_WIDTH-1:0]    req_address     = 0;
+    reg  [15:0]                 req_data        = 0;
+    reg  [ID_WIDTH-1:0]         req_id          = 0;
+    wire                        resp_valid;
+    wire [ID_WIDTH-1:0]         resp_id;
+    wire [15:0]                 resp_data;
+    wire                        mem_cmd_valid;
+    wire                        mem_cmd_ready;
+    wire                        mem_cmd_write;
+    wire [ADDRESS_WIDTH-1:0]    mem_cmd_address;
+    wire [6:0]                  mem_cmd_length;
+    wire                        mem_wr_valid;
+    wire                        mem_wr_ready;
+    wire [15:0]                 mem_wr_data;
+    wire                        mem_rd_valid;
+    wire [15:0]                 mem_rd_data;
+    wire [31:0]                 hit_count;
+    wire [31:0]                 miss_count;
+    wire                        hb_reset_n;
+    wire                        hb_cs_n;
+    wire                        hb_ck_enable;
+    wire [15:0]                 hb_dq_out;
+    wire                        hb_dq_oe;
+    wire [15:0]                 hb_dq_in;
+    wire [1:0]                  hb_rwds_out;
+    wire                        hb_rwds_oe;
+    wire [1:0]                  hb_rwds_in;
+
+    cache
+        #(
+            .ADDRESS_WIDTH( ADDRESS_WIDTH ),
+            .DATA_WIDTH(    16 ),
+            .ID_WIDTH(      ID_WIDTH ),
+            .LINE_WIDTH(    LINE_WIDTH ),
+            .SET_WIDTH(     SET_WIDTH ),
+            .WAYS(          2 ),
+            .WRITE_BACK(    WRITE_BACK ),
+            .LENGTH_WIDTH(  7 )
+        ) dut
+        (
+            .clk(               clk ),
+            .rst(               rst ),
+            .req_valid(         req_valid ),
+            .req_ready(         req_ready ),
+            .req_write(         req_write ),
+            .req_address(       req_address ),
+            .req_data(          req_data ),
+            .req_id(            req_id ),
+            .resp_valid(        resp_valid ),
+            .resp_id(           resp_id ),
+            .resp_data(         resp_data ),
+            .mem_cmd_valid(     mem_cmd_valid ),
+            .mem_cmd_ready(     mem_cmd_ready ),
+            .mem_cmd_write(     mem_cmd_write ),
+            .mem_cmd_address(   mem_cmd_address ),
+            .mem_cmd_length(    mem_cmd_length ),
+            .mem_wr_valid(      mem_wr_valid ),
+            .mem_wr_ready(      mem_wr_ready ),
+            .mem_wr_data(       mem_wr_data ),
+            .mem_rd_valid(      mem_rd_valid ),
+            .mem_rd_data(       mem_rd_data ),
+            .hit_count(         hit_count ),
+            .miss_count(        miss_count )
+        );
+
+    hyperram_controller
+        #(
+            .ADDRESS_WIDTH( ADDRESS_WIDTH ),
+            .LENGTH_WIDTH(  7 ),
+            .MAX_BURST(     16 ),
+            .LATENCY(       LATENCY ),
+            .FIXED_LATENCY( 0 ),
+            .INIT_CLOCKS(   10 )
+        ) controller
+        (
+            .clk(           clk ),
+            .rst(           rst ),
+            .cmd_valid(     mem_cmd_valid ),
+            .cmd_ready(     mem_cmd_ready ),
+            .cmd_write(     mem_cmd_write ),
+            .cmd_register(  1'b0 ),
+            .cmd_address(   mem_cmd_address ),
+            .cmd_length(    mem_cmd_length ),
+            .wr_valid(      mem_wr_valid ),
+            .wr_ready(      mem_wr_ready ),
+            .wr_data(       mem_wr_data ),
+            .wr_strobe(     2'b11 ),
+            .rd_valid(      mem_rd_valid ),
+            .rd_data(       mem_rd_data ),
+            .hb_reset_n(    hb_reset_n ),
+            .hb_cs_n(       hb_cs_n ),
+            .hb_ck_enable(  hb_ck_enable ),
+            .hb_dq_out(     hb_dq_out ),
+            .hb_dq_oe(      hb_dq_oe ),
+            .hb_dq_in(      hb_dq_in ),
+            .hb_rwds_out(   hb_rwds_out ),
+            .hb_rwds_oe(    hb_rwds_oe ),
+            .hb_rwds_in(    hb_rwds_in )
+        );
+
+    hyperram_simulation_model
+        #(
+            .ADDRESS_WIDTH( ADDRESS_WIDTH ),
+            .LATENCY(       LATENCY ),
+            .FIXED_LATENCY( 0 ),
+            .REFRESH_EVERY( REFRESH_EVERY )
+        ) model
+        (
+            .clk(       clk ),
+            .reset_n(   hb_reset_n ),
+            .cs_n(      hb_cs_n ),
+            .ck_enable( hb_ck_enable ),
+            .dq_in(     hb_dq_out ),
+            .dq_out(    hb_dq_in ),
+            .rwds_in(   hb_rwds_out ),
+            .rwds_out(  hb_rwds_in )
+        );
+
+    // reference memory and the reads in flight by req_id, with the word they have to answer
+    reg [15:0]              r_reference     [0:DEPTH-1];
+    reg [15:0]              r_expect_data   [0:IDS-1];
+    reg [ADDRESS_WIDTH-1:0] r_expect_address[0:IDS-1];
+    integer                 r_expect_order  [0:IDS-1];
+    reg [IDS-1:0]           r_pending       = 0;
+    reg [ID_WIDTH-1:0]      r_next_id       = 0;
+    integer                 r_reads         = 0;
+    integer                 r_writes        = 0;
+    integer                 r_answers       = 0;
+    integer                 r_newest        = -1;
+    integer                 r_out_of_order  = 0;
+    integer                 r_seed          = 1;
+    integer                 idx;
+    integer                 tag;
+    integer                 set;
+    initial for( idx = 0; idx < DEPTH; idx = idx + 1 ) r_reference[idx] = 16'd0;
+    wire w_idle = r_pending == 0 && dut.r_valid == 0 && !dut.w_replay_valid && !dut.w_fill_busy
+               && !controller.w_cmd_valid && hb_cs_n;
+
+    `ifndef FORMAL
+        `include "./toolbox/test_bench.v"
+    `else
+        `include "test_bench.v"
+    `endif
+
+    // f_Address - the word address of { tag, set, word }
+    function [ADDRESS_WIDTH-1:0] f_Address;
+        input integer tag, set, word;
+        f_Address = ( tag << ( SET_WIDTH + LINE_WIDTH ) ) | ( set << LINE_WIDTH ) | word;
+    endfunction
+
+    // the reference changes when a write is taken and a read expects the reference of the clock it is
+    // taken, the cache keeps the requests to an address in order
+    task request;
+        input                       write;
+        input [ADDRESS_WIDTH-1:0]   address;
+        input [15:0]                data;
+        begin
+            while( !write && r_pending[r_next_id] ) begin @( posedge clk ); #1; end
+            req_valid   = 1'b1;
+            req_write   = write;
+            req_address = address;
+            req_data    = data;
+            req_id      = r_next_id;
+            while( !req_ready ) begin @( posedge clk ); #1; end
+            @( posedge clk ); #1;
+            req_valid   = 1'b0;
+            if( write ) begin
+                r_reference[address]    = data;
+                r_writes                = r_writes + 1;
+            end else begin
+                r_pending[r_next_id]        = 1'b1;
+                r_expect_data[r_next_id]    = r_reference[address];
+                r_expect_address[r_next_id] = address;
+                r_expect_order[r_next_id]   = r_reads;
+                r_reads                     = r_reads + 1;
+                r_next_id                   = r_next_id + 1'b1;
+            end
+        end
+    endtask
+
+    task write_line;
+        input [ADDRESS_WIDTH-1:0]   address;
+        input integer               pass;
+        integer                     word;
+        begin
+            for( word = 0; word < LINE_WORDS; word = word + 1 )
+                request( 1'b1, address + word, f_Data( address + word, pass ) );
+        end
+    endtask
+
+    task read_line;
+        input [ADDRESS_WIDTH-1:0]   address;
+        integer                     word;
+        begin
+            for( word = 0; word < LINE_WORDS; word = word + 1 )
+                request( 1'b0, address + word, 16'd0 );
+        end
+    endtask
+
+    // answers by req_id, in any order
+    always @( posedge clk ) begin
+        if( resp_valid ) begin
+            if( !r_pending[resp_id] ) begin
+                $display( "unexpected answer %h with id %h", resp_data, resp_id );
+                r_errors = r_errors + 1;
+            end else begin
+                if( resp_data !== r_expect_data[resp_id] ) begin
+                    $display( "read %h at %h, expected %h", resp_data, r_expect_address[resp_id], r_expect_data[resp_id] );
+                    r_errors = r_errors + 1;
+                end
+                if( r_expect_order[resp_id] < r_newest )
+                    r_out_of_order = r_out_of_order + 1;
+                else
+                    r_newest = r_expect_order[resp_id];
+                r_pending[resp_id]  = 1'b0;
+                r_answers           = r_answers + 1;
+            end
+        end
+    end
+
+    // memory commands, whole lines and single words
+    integer r_line_writes   = 0;
+    integer r_word_writes   = 0;
+    integer r_line_reads    = 0;
+    always @( posedge clk ) begin
+        if( mem_cmd_valid && mem_cmd_ready ) begin
+            if( !mem_cmd_write )
+                r_line_reads = r_line_reads + 1;
+            else if( mem_cmd_length == LINE_WORDS - 1 )
+                r_line_writes = r_line_writes + 1;
+            else
+                r_word_writes = r_word_writes + 1;
+        end
+    end
+
+    initial begin
+        repeat( 4 ) @( posedge clk );
+        #1 rst = 1'b0;
+
+        // 1: a line in every set, write through misses are not allocated and are filled by the reads
+        for( set = 0; set < SETS; set = set + 1 )
+            write_line( f_Address( 0, set, 0 ), 1 );
+        for( set = 0; set < SETS; set = set + 1 )
+            read_line( f_Address( 0, set, 0 ) );
+        wait_idle;
+
+        // 2: hits under a miss, the miss to set 1 is answered after the hits to sets 0 and 2 behind it
+        request( 1'b0, f_Address( 16, 1, 0 ), 16'd0 );
+        read_line( f_Address( 0, 0, 0 ) );
+        request( 1'b1, f_Address( 0, 2, 1 ), f_Data( f_Address( 0, 2, 1 ), 2 ) );
+        read_line( f_Address( 0, 2, 0 ) );
+        request( 1'b0, f_Address( 16, 1, 0 ), 16'd0 );
+        wait_idle;
+
+        // 3: more tags than ways in set 2, dirty lines are replaced and read back from the memory
+        write_line( f_Address( 1, 2, 0 ), 3 );
+        write_line( f_Address( 2, 2, 0 ), 3 );
+        read_line( f_Address( 0, 2, 0 ) );
+        write_line( f_Address( 3, 2, 0 ), 3 );
+        request( 1'b1, f_Address( 1, 2, 2 ), f_Data( f_Address( 1, 2, 2 ), 4 ) );
+        request( 1'b0, f_Address( 1, 2, 2 ), 16'd0 );
+        for( tag = 0; tag < 4; tag = tag + 1 )
+            read_line( f_Address( tag, 2, 0 ) );
+        wait_idle;
+
+        // 4: random reads and writes, tags 0 .. 7
+        for( idx = 0; idx < 1000; idx = idx + 1 )
+            request( $random( r_seed ) & 1, $random( r_seed ) & 'h7f, $random( r_seed ) );
+        wait_idle;
+
+        // 5: 4 fills of unused tags per set replace both ways of the set, the fills of a set run back to
+        //    back so the round robin victim alternates
+        for( set = 0; set < SETS; set = set + 1 ) begin
+            for( tag = 'h3c; tag < 'h40; tag = tag + 1 )
+                request( 1'b0, f_Address( tag, set, 0 ), 16'd0 );
+            wait_idle;
+        end
+
+        // every word of the memory, nothing may be left behind in the cache
+        for( idx = 0; idx < DEPTH; idx = idx + 1 ) begin
+            if( model.r_memory[idx] !== r_reference[idx] ) begin
+                $display( "memory %h is %h, expected %h", idx, model.r_memory[idx], r_reference[idx] );
+                r_errors = r_errors + 1;
+            end
+        end
+        if( r_answers != r_reads ) begin
+            $display( "%0d answers to %0d reads", r_answers, r_reads );
+            r_errors = r_errors + 1;
+        end
+        if( r_out_of_order == 0 ) begin
+            $display( "no answer left out of order" );
+            r_errors = r_errors + 1;
+        end
+        if( hit_count + miss_count != r_reads + r_writes ) begin
+            $display( "%0d hits and %0d misses for %0d requests", hit_count, miss_count, r_reads + r_writes );
+            r_errors = r_errors + 1;
+        end
+        if( WRITE_BACK && ( r_line_writes == 0 || r_word_writes != 0 ) ) begin
+            $display( "write back, %0d lines and %0d words written", r_line_writes, r_word_writes );
+            r_errors = r_errors + 1;
+        end
+        if( !WRITE_BACK && ( r_line_writes != 0 || r_word_writes != r_writes ) ) begin
+            $display( "write through, %0d lines and %0d words written for %0d writes", r_line_writes, r_word_writes, r_writes );
+            r_errors = r_errors + 1;
+        end
+        $display( "cache_tb: WRITE_BACK %0d, %0d reads, %0d writes, %0d hits, %0d misses, %0d out of order, %0d line fills, %0d line writes",
+            WRITE_BACK, r_reads, r_writes, hit_count, miss_count, r_out_of_order, r_line_reads, r_line_writes );
+        test_bench_finish;
+    end
+endmodule
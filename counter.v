@@ -198,4 +198,61 @@ module counter_with_strobe
     always @( posedge clk ) cover( valid );
 
 `endif
+endmodule
+
+// counter_chunked - a free running up counter that can count every clock.
+// The counter is split into 'ALU_WIDTH' chunks. Instead of rippling the carry through the
+// whole counter, each chunk keeps a registered 'full' flag (chunk == all ones) that is updated
+// along with the chunk. The carry into a chunk is the AND of the lower chunk's flags, so the
+// critical path is a single chunk increment plus a CHUNK_COUNT input AND.
+//  load    - count = load_value, has priority over enable
+//  enable  - count = count + 1
+//  full    - count is all ones, the AND of the registered flags. Loading ~( n - 1 ) makes 'full' mark
+//            the n-th count, a down counter without a wide compare.
+module counter_chunked
+    #( 
+        parameter WIDTH     = 32,
+        parameter ALU_WIDTH = 8
+    )
+    (
+        input   wire                clk,
+        input   wire                rst,
+        input   wire                load,
+        input   wire [WIDTH-1:0]    load_value,
+        input   wire                enable,
+        output  wire [WIDTH-1:0]    count,
+        output  wire                full
+    );
+    localparam CHUNK_COUNT = WIDTH % ALU_WIDTH == 0 ? WIDTH / ALU_WIDTH : WIDTH / ALU_WIDTH + 1;
+    localparam LAST_CHUNK_SIZE = WIDTH % ALU_WIDTH == 0 ? ALU_WIDTH : WIDTH % ALU_WIDTH;
+
+    reg [WIDTH-1:0]         counter_ff  = 'd0;
+    reg [CHUNK_COUNT-1:0]   full_ff     = 'd0;
+    assign count = counter_ff;
+    assign full  = &full_ff;
+
+    genvar idx;
+    generate
+        for( idx = 0; idx < CHUNK_COUNT; idx = idx + 1 ) begin : counter_chunk_loop
+            localparam CHUNK_SIZE = idx != CHUNK_COUNT - 1 ? ALU_WIDTH : LAST_CHUNK_SIZE;
+            wire                    w_carry;
+            if( idx == 0 )
+                assign w_carry = enable;
+            else
+                assign w_carry = enable && &full_ff[idx-1:0];
+            wire [CHUNK_SIZE-1:0]   w_next  = counter_ff[idx*ALU_WIDTH+:CHUNK_SIZE] + 1'b1;
+            always @( posedge clk ) begin
+                if( rst ) begin
+                    counter_ff[idx*ALU_WIDTH+:CHUNK_SIZE]   <= 'd0;
+                    full_ff[idx]                            <= 1'b0;
+                end else if( load ) begin
+                    counter_ff[idx*ALU_WIDTH+:CHUNK_SIZE]   <= load_value[idx*ALU_WIDTH+:CHUNK_SIZE];
+                    full_ff[idx]                            <= &load_value[idx*ALU_WIDTH+:CHUNK_SIZE];
+                end else if( w_carry ) begin
+                    counter_ff[idx*ALU_WIDTH+:CHUNK_SIZE]   <= w_next;
+                    full_ff[idx]                            <= &w_next;
+                end
+            end
+        end
+    endgenerate
 endmodule
\ No newline at end of file
@@ -0,0 +1,676 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	ddr_io.v
+//
+// Project:	ddr io
+//
+// Purpose:	Simulation models of the Gowin DDR and serializer / deserializer
+//          io primitives and stream gearboxes built on them.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+`ifdef FORMAL
+    `define TEST_BENCH_RUNNING
+`endif
+`ifdef TEST_BENCH_RUNNING
+    `define IDDR_PRIMITIVE      iddr_simulation_wrapper
+    `define ODDR_PRIMITIVE      oddr_simulation_wrapper
+    `define IDES4_PRIMITIVE     ides4_simulation_wrapper
+    `define IDES8_PRIMITIVE     ides8_simulation_wrapper
+    `define IDES10_PRIMITIVE    ides10_simulation_wrapper
+    `define OSER4_PRIMITIVE     oser4_simulation_wrapper
+    `define OSER8_PRIMITIVE     oser8_simulation_wrapper
+    `define OSER10_PRIMITIVE    oser10_simulation_wrapper
+`else
+    `define IDDR_PRIMITIVE      IDDR
+    `define ODDR_PRIMITIVE      ODDR
+    `define IDES4_PRIMITIVE     IDES4
+    `define IDES8_PRIMITIVE     IDES8
+    `define IDES10_PRIMITIVE    IDES10
+    `define OSER4_PRIMITIVE     OSER4
+    `define OSER8_PRIMITIVE     OSER8
+    `define OSER10_PRIMITIVE    OSER10
+`endif
+
+// iddr_simulation_wrapper - IDDR, D is taken on both edges of CLK, Q0 the rising and Q1 the following
+// falling edge, both are updated on the next rising edge
+module iddr_simulation_wrapper
+    #(
+        parameter Q0_INIT = 1'b0,
+        parameter Q1_INIT = 1'b0
+    )
+    (
+        output  wire    Q0,
+        output  wire    Q1,
+        input   wire    D,
+        input   wire    CLK
+    );
+    reg r_rise  = Q0_INIT;
+    reg r_fall  = Q1_INIT;
+    reg r_q0    = Q0_INIT;
+    reg r_q1    = Q1_INIT;
+    assign Q0 = r_q0;
+    assign Q1 = r_q1;
+    always @( posedge CLK ) begin
+        r_rise  <= D;
+        r_q0    <= r_rise;
+        r_q1    <= r_fall;
+    end
+    always @( negedge CLK ) r_fall <= D;
+endmodule
+
+// oddr_simulation_wrapper - ODDR, D0 and D1 are taken on the rising edge of CLK, Q0 is D0 while CLK is high
+// and D1 while CLK is low, starting on the next rising edge. Q1 is TX, taken on the rising edge for
+// TXCLK_POL 0 and on the falling edge for TXCLK_POL 1
+module oddr_simulation_wrapper
+    #(
+        parameter INIT      = 1'b0,
+        parameter TXCLK_POL = 1'b0
+    )
+    (
+        output  wire    Q0,
+        output  wire    Q1,
+        input   wire    D0,
+        input   wire    D1,
+        input   wire    TX,
+        input   wire    CLK
+    );
+    reg r_d0        = INIT;
+    reg r_d1        = INIT;
+    reg r_rise      = INIT;
+    reg r_fall_next = INIT;     // D1 of the same word as r_rise, waiting for the falling edge
+    reg r_fall      = INIT;
+    reg r_tx_rise   = 1'b0;
+    reg r_tx_fall   = 1'b0;
+    assign Q0 = CLK ? r_rise : r_fall;
+    assign Q1 = TXCLK_POL ? r_tx_fall : r_tx_rise;
+    always @( posedge CLK ) begin
+        r_d0        <= D0;
+        r_d1        <= D1;
+        r_rise      <= r_d0;
+        r_fall_next <= r_d1;
+        r_tx_rise   <= TX;
+    end
+    always @( negedge CLK ) begin
+        r_fall      <= r_fall_next;
+        r_tx_fall   <= TX;
+    end
+endmodule
+
+// ides_simulation_model - RATIO : 1 deserializer, the common core of the IDES4, IDES8 and IDES10 models
+//  D is taken on both edges of FCLK, RATIO / 2 FCLK clocks per PCLK clock with the rising edges aligned.
+//  On the rising edge of PCLK, Q takes the last RATIO bits, Q[0] the oldest. Every rising edge of CALIB,
+//  taken on PCLK, moves the word 1 bit later, RATIO edges bring it back. RESET clears Q and the slip.
+module ides_simulation_model
+    #(
+        parameter RATIO = 4
+    )
+    (
+        input   wire                D,
+        input   wire                FCLK,
+        input   wire                PCLK,
+        input   wire                CALIB,
+        input   wire                RESET,
+        output  wire [RATIO-1:0]    Q
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+
+    reg [2*RATIO-1:0]       r_history   = 0;    // newest bit in bit 0
+    reg [RATIO-1:0]         r_q         = 0;
+    reg [f_Log2(RATIO)-1:0] r_slip      = 0;
+    reg                     r_calib     = 0;
+    assign Q = r_q;
+
+    always @( FCLK ) r_history <= { r_history[2*RATIO-2:0], D };
+
+    integer idx;
+    always @( posedge PCLK ) begin
+        r_calib <= CALIB;
+        if( CALIB && !r_calib )
+            r_slip <= r_slip == RATIO - 1 ? 'd0 : r_slip + 1'b1;
+        for( idx = 0; idx < RATIO; idx = idx + 1 )
+            r_q[idx] <= r_history[RATIO-1-idx+r_slip];
+        if( RESET ) begin
+            r_q     <= 'd0;
+            r_slip  <= 'd0;
+        end
+    end
+endmodule
+
+// oser_simulation_model - RATIO : 1 serializer, the common core of the OSER4, OSER8 and OSER10 models
+//  D is taken on the rising edge of PCLK and sent on Q0 from the next edge of FCLK, D[0] first, 1 bit on
+//  each edge of FCLK. TX_RATIO bits of TX are sent the same way on Q1, 1 per rising edge of FCLK.
+module oser_simulation_model
+    #(
+        parameter RATIO     = 4,
+        parameter TX_RATIO  = 2
+    )
+    (
+        input   wire [RATIO-1:0]    D,
+        input   wire [( TX_RATIO == 0 ? 1 : TX_RATIO )-1:0] TX,
+        input   wire                FCLK,
+        input   wire                PCLK,
+        input   wire                RESET,
+        output  wire                Q0,
+        output  wire                Q1
+    );
+    localparam TX_WIDTH = TX_RATIO == 0 ? 1 : TX_RATIO;
+
+    reg [RATIO-1:0]     r_word          = 0;
+    reg [TX_WIDTH-1:0]  r_tx_word       = 0;
+    reg                 r_load          = 0;    // toggles on every PCLK, the FCLK side loads when it sees a change
+    reg                 r_loaded        = 0;
+    reg                 r_tx_loaded     = 0;
+    reg [RATIO-1:0]     r_shift         = 0;
+    reg [TX_WIDTH-1:0]  r_tx_shift      = 0;
+    reg                 r_q0            = 0;
+    reg                 r_q1            = 0;
+    assign Q0 = r_q0;
+    assign Q1 = r_q1;
+
+    always @( posedge PCLK ) begin
+        r_word      <= RESET ? { RATIO{1'b0} } : D;
+        r_tx_word   <= RESET ? { TX_WIDTH{1'b0} } : TX;
+        r_load      <= !r_load;
+    end
+    always @( FCLK ) begin
+        if( r_load != r_loaded ) begin
+            r_loaded    <= r_load;
+            r_shift     <= r_word >> 1;
+            r_q0        <= r_word[0];
+        end else begin
+            r_shift     <= r_shift >> 1;
+            r_q0        <= r_shift[0];
+        end
+        if( FCLK && TX_RATIO != 0 ) begin
+            if( r_load != r_tx_loaded ) begin
+                r_tx_loaded <= r_load;
+                r_tx_shift  <= r_tx_word >> 1;
+                r_q1        <= r_tx_word[0];
+            end else begin
+                r_tx_shift  <= r_tx_shift >> 1;
+                r_q1        <= r_tx_shift[0];
+            end
+        end
+    end
+endmodule
+
+// ides4_simulation_wrapper - IDES4, 4 : 1, FCLK = 2 * PCLK
+module ides4_simulation_wrapper
+    #(
+        parameter GSREN = "false",
+        parameter LSREN = "true"
+    )
+    (
+        output  wire    Q0,
+        output  wire    Q1,
+        output  wire    Q2,
+        output  wire    Q3,
+        input   wire    D,
+        input   wire    FCLK,
+        input   wire    PCLK,
+        input   wire    CALIB,
+        input   wire    RESET
+    );
+    ides_simulation_model #( .RATIO( 4 ) ) deserializer
+    (
+        .D(     D ),
+        .FCLK(  FCLK ),
+        .PCLK(  PCLK ),
+        .CALIB( CALIB ),
+        .RESET( RESET ),
+        .Q(     { Q3, Q2, Q1, Q0 } )
+    );
+endmodule
+
+// ides8_simulation_wrapper - IDES8, 8 : 1, FCLK = 4 * PCLK
+module ides8_simulation_wrapper
+    #(
+        parameter GSREN = "false",
+        parameter LSREN = "true"
+    )
+    (
+        output  wire    Q0,
+        output  wire    Q1,
+        output  wire    Q2,
+        output  wire    Q3,
+        output  wire    Q4,
+        output  wire    Q5,
+        output  wire    Q6,
+        output  wire    Q7,
+        input   wire    D,
+        input   wire    FCLK,
+        input   wire    PCLK,
+        input   wire    CALIB,
+        input   wire    RESET
+    );
+    ides_simulation_model #( .RATIO( 8 ) ) deserializer
+    (
+        .D(     D ),
+        .FCLK(  FCLK ),
+        .PCLK(  PCLK ),
+        .CALIB( CALIB ),
+        .RESET( RESET ),
+        .Q(     { Q7, Q6, Q5, Q4, Q3, Q2, Q1, Q0 } )
+    );
+endmodule
+
+// ides10_simulation_wrapper - IDES10, 10 : 1, FCLK = 5 * PCLK
+module ides10_simulation_wrapper
+    #(
+        parameter GSREN = "false",
+        parameter LSREN = "true"
+    )
+    (
+        output  wire    Q0,
+        output  wire    Q1,
+        output  wire    Q2,
+        output  wire    Q3,
+        output  wire    Q4,
+        output  wire    Q5,
+        output  wire    Q6,
+        output  wire    Q7,
+        output  wire    Q8,
+        output  wire    Q9,
+        input   wire    D,
+        input   wire    FCLK,
+        input   wire    PCLK,
+        input   wire    CALIB,
+        input   wire    RESET
+    );
+    ides_simulation_model #( .RATIO( 10 ) ) deserializer
+    (
+        .D(     D ),
+        .FCLK(  FCLK ),
+        .PCLK(  PCLK ),
+        .CALIB( CALIB ),
+        .RESET( RESET ),
+        .Q(     { Q9, Q8, Q7, Q6, Q5, Q4, Q3, Q2, Q1, Q0 } )
+    );
+endmodule
+
+// oser4_simulation_wrapper - OSER4, 4 : 1, FCLK = 2 * PCLK, TX0 and TX1 serialized on Q1
+module oser4_simulation_wrapper
+    #(
+        parameter GSREN     = "false",
+        parameter LSREN     = "true",
+        parameter HWL       = "false",
+        parameter TXCLK_POL = 1'b0
+    )
+    (
+        output  wire    Q0,
+        output  wire    Q1,
+        input   wire    D0,
+        input   wire    D1,
+        input   wire    D2,
+        input   wire    D3,
+        input   wire    TX0,
+        input   wire    TX1,
+        input   wire    PCLK,
+        input   wire    FCLK,
+        input   wire    RESET
+    );
+    oser_simulation_model #( .RATIO( 4 ), .TX_RATIO( 2 ) ) serializer
+    (
+        .D(     { D3, D2, D1, D0 } ),
+        .TX(    { TX1, TX0 } ),
+        .FCLK(  FCLK ),
+        .PCLK(  PCLK ),
+        .RESET( RESET ),
+        .Q0(    Q0 ),
+        .Q1(    Q1 )
+    );
+endmodule
+
+// oser8_simulation_wrapper - OSER8, 8 : 1, FCLK = 4 * PCLK, TX0 .. TX3 serialized on Q1
+module oser8_simulation_wrapper
+    #(
+        parameter GSREN     = "false",
+        parameter LSREN     = "true",
+        parameter HWL       = "false",
+        parameter TXCLK_POL = 1'b0
+    )
+    (
+        output  wire    Q0,
+        output  wire    Q1,
+        input   wire    D0,
+        input   wire    D1,
+        input   wire    D2,
+        input   wire    D3,
+        input   wire    D4,
+        input   wire    D5,
+        input   wire    D6,
+        input   wire    D7,
+        input   wire    TX0,
+        input   wire    TX1,
+        input   wire    TX2,
+        input   wire    TX3,
+        input   wire    PCLK,
+        input   wire    FCLK,
+        input   wire    RESET
+    );
+    oser_simulation_model #( .RATIO( 8 ), .TX_RATIO( 4 ) ) serializer
+    (
+        .D(     { D7, D6, D5, D4, D3, D2, D1, D0 } ),
+        .TX(    { TX3, TX2, TX1, TX0 } ),
+        .FCLK(  FCLK ),
+        .PCLK(  PCLK ),
+        .RESET( RESET ),
+        .Q0(    Q0 ),
+        .Q1(    Q1 )
+    );
+endmodule
+
+// oser10_simulation_wrapper - OSER10, 10 : 1, FCLK = 5 * PCLK, no tristate output
+module oser10_simulation_wrapper
+    #(
+        parameter GSREN = "false",
+        parameter LSREN = "true"
+    )
+    (
+        output  wire    Q,
+        input   wire    D0,
+        input   wire    D1,
+        input   wire    D2,
+        input   wire    D3,
+        input   wire    D4,
+        input   wire    D5,
+        input   wire    D6,
+        input   wire    D7,
+        input   wire    D8,
+        input   wire    D9,
+        input   wire    PCLK,
+        input   wire    FCLK,
+        input   wire    RESET
+    );
+    oser_simulation_model #( .RATIO( 10 ), .TX_RATIO( 0 ) ) serializer
+    (
+        .D(     { D9, D8, D7, D6, D5, D4, D3, D2, D1, D0 } ),
+        .TX(    1'b0 ),
+        .FCLK(  FCLK ),
+        .PCLK(  PCLK ),
+        .RESET( RESET ),
+        .Q0(    Q ),
+        .Q1()
+    );
+endmodule
+
+// serdes_rx_gearbox - serial_in through an IDES4, IDES8 or IDES10 into words of WORDS * RATIO bits, bit 0 first
+//  out_data is a word every WORDS pclk clocks when out_valid is set. While 'align' is set the words are
+//  compared with ALIGN_PATTERN in every RATIO bit chunk, on a mismatch the IDES is slipped 1 bit with CALIB,
+//  every RATIO slips the word is also moved 1 chunk, and SETTLE_CLOCKS later the next word is compared.
+//  'aligned' is set from the first match until 'align' is set again, the alignment is kept while 'align' is clear.
+//  ALIGN_PATTERN MUST differ from its own rotations, the default is picked for RATIO 4, 8 and 10. A pattern
+//  repeated in every chunk finds the chunk boundary, the word boundary for WORDS > 1 is left to the protocol.
+module serdes_rx_gearbox
+    #(
+        parameter RATIO         = 10,
+        parameter WORDS         = 1,
+        parameter [RATIO-1:0] ALIGN_PATTERN = RATIO == 4 ? 4'b1100 : RATIO == 8 ? 8'b11010100 : 10'b1101010100,
+        parameter SETTLE_CLOCKS = 8
+    )
+    (
+        input   wire                        fclk,
+        input   wire                        pclk,
+        input   wire                        rst,
+        input   wire                        serial_in,
+        input   wire                        align,
+        output  wire                        aligned,
+        output  wire                        out_valid,
+        output  wire [WORDS*RATIO-1:0]      out_data
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    localparam WIDTH = WORDS * RATIO;
+
+    wire [RATIO-1:0] w_chunk;
+    reg              r_calib = 0;
+    generate
+        if( RATIO == 4 ) begin
+            `IDES4_PRIMITIVE deserializer( .D( serial_in ), .FCLK( fclk ), .PCLK( pclk ), .CALIB( r_calib ), .RESET( rst ),
+                .Q0( w_chunk[0] ), .Q1( w_chunk[1] ), .Q2( w_chunk[2] ), .Q3( w_chunk[3] ) );
+            defparam deserializer.GSREN = "false";
+            defparam deserializer.LSREN = "true";
+        end else if( RATIO == 8 ) begin
+            `IDES8_PRIMITIVE deserializer( .D( serial_in ), .FCLK( fclk ), .PCLK( pclk ), .CALIB( r_calib ), .RESET( rst ),
+                .Q0( w_chunk[0] ), .Q1( w_chunk[1] ), .Q2( w_chunk[2] ), .Q3( w_chunk[3] ),
+                .Q4( w_chunk[4] ), .Q5( w_chunk[5] ), .Q6( w_chunk[6] ), .Q7( w_chunk[7] ) );
+            defparam deserializer.GSREN = "false";
+            defparam deserializer.LSREN = "true";
+        end else begin
+            `IDES10_PRIMITIVE deserializer( .D( serial_in ), .FCLK( fclk ), .PCLK( pclk ), .CALIB( r_calib ), .RESET( rst ),
+                .Q0( w_chunk[0] ), .Q1( w_chunk[1] ), .Q2( w_chunk[2] ), .Q3( w_chunk[3] ), .Q4( w_chunk[4] ),
+                .Q5( w_chunk[5] ), .Q6( w_chunk[6] ), .Q7( w_chunk[7] ), .Q8( w_chunk[8] ), .Q9( w_chunk[9] ) );
+            defparam deserializer.GSREN = "false";
+            defparam deserializer.LSREN = "true";
+        end
+    endgenerate
+
+    // the chunks shift in from the top, the word is complete when the chunk count wraps
+    reg  [WIDTH-1:0]                r_word      = 0;
+    reg  [f_Log2(WORDS+1)-1:0]      r_count     = 0;
+    reg                             r_out_valid = 0;
+    reg  [WIDTH-1:0]                r_out_data  = 0;
+    reg                             r_skip      = 0;
+    wire [WIDTH-1:0]                w_word      = ( { w_chunk, r_word } >> RATIO );
+    assign out_valid    = r_out_valid;
+    assign out_data     = r_out_data;
+    always @( posedge pclk ) begin
+        r_word      <= w_word;
+        r_out_valid <= 1'b0;
+        if( !r_skip ) begin
+            r_count <= r_count == WORDS - 1 ? 'd0 : r_count + 1'b1;
+            if( r_count == WORDS - 1 ) begin
+                r_out_valid <= 1'b1;
+                r_out_data  <= w_word;
+            end
+        end
+        if( rst ) begin
+            r_count     <= 'd0;
+            r_out_valid <= 1'b0;
+        end
+    end
+
+    // alignment search
+    reg                                 r_aligned   = 0;
+    reg  [f_Log2(RATIO)-1:0]            r_slips     = 0;
+    reg  [f_Log2(SETTLE_CLOCKS+1)-1:0]  r_settle    = 0;
+    reg                                 r_align     = 0;
+    assign aligned = r_aligned;
+    always @( posedge pclk ) begin
+        r_align <= align;
+        r_calib <= 1'b0;
+        r_skip  <= 1'b0;
+        if( r_settle != 0 )
+            r_settle <= r_settle - 1'b1;
+        if( align && !r_align )
+            r_aligned <= 1'b0;
+        if( align && !r_aligned && r_out_valid && r_settle == 0 ) begin
+            if( r_out_data == { WORDS{ ALIGN_PATTERN } } ) begin
+                r_aligned <= 1'b1;
+            end else begin
+                r_calib     <= 1'b1;
+                r_settle    <= SETTLE_CLOCKS;
+                r_slips     <= r_slips == RATIO - 1 ? 'd0 : r_slips + 1'b1;
+                if( r_slips == RATIO - 1 )
+                    r_skip  <= 1'b1;
+            end
+        end
+        if( rst ) begin
+            r_aligned   <= 1'b0;
+            r_slips     <= 'd0;
+            r_settle    <= 'd0;
+            r_calib     <= 1'b0;
+            r_skip      <= 1'b0;
+        end
+    end
+endmodule
+
+// serdes_tx_gearbox - words of WORDS * RATIO bits through an OSER4, OSER8 or OSER10 to serial_out, bit 0 first
+//  A word is taken on the clock in_valid and in_ready are set, in_ready is set every WORDS pclk clocks. When
+//  there is no word IDLE_PATTERN is sent in every RATIO bit chunk, so the link never stops and a
+//  serdes_rx_gearbox with the same ALIGN_PATTERN can train on it.
+module serdes_tx_gearbox
+    #(
+        parameter RATIO         = 10,
+        parameter WORDS         = 1,
+        parameter [RATIO-1:0] IDLE_PATTERN = RATIO == 4 ? 4'b1100 : RATIO == 8 ? 8'b11010100 : 10'b1101010100
+    )
+    (
+        input   wire                        fclk,
+        input   wire                        pclk,
+        input   wire                        rst,
+        input   wire                        in_valid,
+        output  wire                        in_ready,
+        input   wire [WORDS*RATIO-1:0]      in_data,
+        output  wire                        serial_out
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    localparam WIDTH = WORDS * RATIO;
+
+    reg  [WIDTH-1:0]            r_word  = 0;
+    reg  [f_Log2(WORDS+1)-1:0]  r_count = 0;
+    reg  [RATIO-1:0]            r_chunk = 0;
+    wire [WIDTH-1:0]            w_word  = in_valid ? in_data : { WORDS{ IDLE_PATTERN } };
+    assign in_ready = r_count == 0;
+    always @( posedge pclk ) begin
+        r_count <= r_count == WORDS - 1 ? 'd0 : r_count + 1'b1;
+        if( r_count == 0 ) begin
+            r_chunk <= w_word[RATIO-1:0];
+            r_word  <= w_word >> RATIO;
+        end else begin
+            r_chunk <= r_word[RATIO-1:0];
+            r_word  <= r_word >> RATIO;
+        end
+        if( rst )
+            r_count <= 'd0;
+    end
+
+    generate
+        if( RATIO == 4 ) begin
+            `OSER4_PRIMITIVE serializer( .Q0( serial_out ), .Q1(), .D0( r_chunk[0] ), .D1( r_chunk[1] ), .D2( r_chunk[2] ), .D3( r_chunk[3] ),
+                .TX0( 1'b0 ), .TX1( 1'b0 ), .PCLK( pclk ), .FCLK( fclk ), .RESET( rst ) );
+            defparam serializer.GSREN       = "false";
+            defparam serializer.LSREN       = "true";
+            defparam serializer.HWL         = "false";
+            defparam serializer.TXCLK_POL   = 1'b0;
+        end else if( RATIO == 8 ) begin
+            `OSER8_PRIMITIVE serializer( .Q0( serial_out ), .Q1(), .D0( r_chunk[0] ), .D1( r_chunk[1] ), .D2( r_chunk[2] ), .D3( r_chunk[3] ),
+                .D4( r_chunk[4] ), .D5( r_chunk[5] ), .D6( r_chunk[6] ), .D7( r_chunk[7] ),
+                .TX0( 1'b0 ), .TX1( 1'b0 ), .TX2( 1'b0 ), .TX3( 1'b0 ), .PCLK( pclk ), .FCLK( fclk ), .RESET( rst ) );
+            defparam serializer.GSREN       = "false";
+            defparam serializer.LSREN       = "true";
+            defparam serializer.HWL         = "false";
+            defparam serializer.TXCLK_POL   = 1'b0;
+        end else begin
+            `OSER10_PRIMITIVE serializer( .Q( serial_out ), .D0( r_chunk[0] ), .D1( r_chunk[1] ), .D2( r_chunk[2] ), .D3( r_chunk[3] ),
+                .D4( r_chunk[4] ), .D5( r_chunk[5] ), .D6( r_chunk[6] ), .D7( r_chunk[7] ), .D8( r_chunk[8] ), .D9( r_chunk[9] ),
+                .PCLK( pclk ), .FCLK( fclk ), .RESET( rst ) );
+            defparam serializer.GSREN       = "false";
+            defparam serializer.LSREN       = "true";
+        end
+    endgenerate
+endmodule
+
+// hyperram_io - the HyperRAM pins for the hb_* ports of 'hyperram_controller'
+//  Every dq and rwds pin is an ODDR, whose Q1 is the tristate enable, and an IDDR, both on clk, the first byte
+//  goes out and comes in on the rising edge. CS#, RESET# and CK are ODDRs as well so all outputs move together,
+//  CK runs on clk_shift, clk shifted 90 degrees, which puts its edges in the middle of the write data bytes.
+//  The CK enable takes 1 more clk register, its ODDR takes it on clk_shift a quarter clock after the data
+//  ODDRs take theirs, so without it CK would lead the data by 3 / 4 clock instead of lagging by 1 / 4.
+//  The outputs and the inputs each add 1 clock. The write latency is counted on outputs that are all delayed
+//  alike and the reads follow rwds, but the rwds the memory drives during the command comes back 2 clocks
+//  late, so the controller's FIXED_LATENCY MUST BE 1 behind hyperram_io.
+module hyperram_io
+    (
+        input   wire            clk,
+        input   wire            clk_shift,
+        // controller side
+        input   wire            hb_reset_n,
+        input   wire            hb_cs_n,
+        input   wire            hb_ck_enable,
+        input   wire    [15:0]  hb_dq_out,
+        input   wire            hb_dq_oe,
+        output  wire    [15:0]  hb_dq_in,
+        input   wire    [1:0]   hb_rwds_out,
+        input   wire            hb_rwds_oe,
+        output  wire    [1:0]   hb_rwds_in,
+        // pins
+        output  wire            hyperram_reset_n,
+        output  wire            hyperram_cs_n,
+        output  wire            hyperram_ck,
+        inout   wire    [7:0]   hyperram_dq,
+        inout   wire            hyperram_rwds
+    );
+    `ODDR_PRIMITIVE reset_oddr( .Q0( hyperram_reset_n ), .Q1(), .D0( hb_reset_n ), .D1( hb_reset_n ), .TX( 1'b0 ), .CLK( clk ) );
+    defparam reset_oddr.INIT = 1'b0;
+    `ODDR_PRIMITIVE cs_oddr( .Q0( hyperram_cs_n ), .Q1(), .D0( hb_cs_n ), .D1( hb_cs_n ), .TX( 1'b0 ), .CLK( clk ) );
+    defparam cs_oddr.INIT = 1'b1;
+    reg r_ck_enable = 0;
+    always @( posedge clk ) r_ck_enable <= hb_ck_enable;
+    `ODDR_PRIMITIVE ck_oddr( .Q0( hyperram_ck ), .Q1(), .D0( r_ck_enable ), .D1( 1'b0 ), .TX( 1'b0 ), .CLK( clk_shift ) );
+    defparam ck_oddr.INIT = 1'b0;
+
+    // the ODDR takes TX 1 register before D0 / D1, the extra register lines the enable up with the data
+    reg r_dq_oe     = 0;
+    reg r_rwds_oe   = 0;
+    always @( posedge clk ) begin
+        r_dq_oe     <= hb_dq_oe;
+        r_rwds_oe   <= hb_rwds_oe;
+    end
+
+    // pin 8 is rwds
+    wire [8:0] w_first  = { hb_rwds_out[1], hb_dq_out[15:8] };
+    wire [8:0] w_second = { hb_rwds_out[0], hb_dq_out[7:0] };
+    wire [8:0] w_oe     = { r_rwds_oe, { 8{ r_dq_oe } } };
+    wire [8:0] w_pins   = { hyperram_rwds, hyperram_dq };
+    wire [8:0] w_in_first;
+    wire [8:0] w_in_second;
+    assign hb_dq_in     = { w_in_first[7:0], w_in_second[7:0] };
+    assign hb_rwds_in   = { w_in_first[8], w_in_second[8] };
+    genvar idx;
+    generate
+        for( idx = 0; idx < 9; idx = idx + 1 ) begin : hyperram_pin_loop
+            wire w_q;
+            wire w_oen;
+            `ODDR_PRIMITIVE pin_oddr( .Q0( w_q ), .Q1( w_oen ), .D0( w_first[idx] ), .D1( w_second[idx] ), .TX( ~w_oe[idx] ), .CLK( clk ) );
+            defparam pin_oddr.INIT      = 1'b0;
+            defparam pin_oddr.TXCLK_POL = 1'b0;
+            `IDDR_PRIMITIVE pin_iddr( .Q0( w_in_first[idx] ), .Q1( w_in_second[idx] ), .D( w_pins[idx] ), .CLK( clk ) );
+            if( idx == 8 )
+                assign hyperram_rwds    = w_oen ? 1'bz : w_q;
+            else
+                assign hyperram_dq[idx] = w_oen ? 1'bz : w_q;
+        end
+    endgenerate
+endmodule
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	ddr_io_tb.v
+//
+// Project:	ddr io
+//
+// Purpose:	Test bench for the ODDR simulation model, known D0 / D1 pairs are
+//          checked on both phases of the output clock.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// ddr_io_tb - drives oddr_simulation_wrapper with a new D0, D1 and TX every clock and checks Q0 while CLK
+//  is high, the D0 of 2 clocks before, while CLK is low, the D1 of the same word, and Q1, the TX of 1 clock
+//  before. ddr_io.v is compiled with TEST_BENCH_RUNNING so its primitives are the models.
+module ddr_io_tb
+    #(
+        parameter WORDS = 256
+    );
+    localparam LATENCY  = 2;
+    localparam BENCH    = "ddr_io_tb";
+    localparam TIMEOUT  = 10 * ( WORDS + LATENCY + 100 );
+
+    reg clk = 0;
+    always #5 clk = !clk;
+
+    reg     r_d0        = 0;
+    reg     r_d1        = 0;
+    reg     r_tx        = 0;
+    reg     r_running   = 0;
+    wire    w_q0;
+    wire    w_q1;
+    oddr_simulation_wrapper #( .INIT( 1'b0 ), .TXCLK_POL( 1'b0 ) ) dut
+    (
+        .Q0(    w_q0 ),
+        .Q1(    w_q1 ),
+        .D0(    r_d0 ),
+        .D1(    r_d1 ),
+        .TX(    r_tx ),
+        .CLK(   clk )
+    );
+    wire w_idle = !r_running;
+
+    `ifndef FORMAL
+        `include "./toolbox/test_bench.v"
+    `else
+        `include "test_bench.v"
+    `endif
+
+    //  f_Word - Returns { TX, D1, D0 } of a word
+    function [2:0] f_Word;
+        input integer word;
+        reg [15:0] data;
+        begin
+            data    = f_Data( word, 0 );
+            f_Word  = data[10:8];
+        end
+    endfunction
+
+    //  check_bit - counts a mismatch in r_errors
+    task check_bit;
+        input [8*8-1:0] name;
+        input integer   word;
+        input           result;
+        input           expected;
+        begin
+            if( result !== expected ) begin
+                $display( "%0s of word %0d is %b, expected %b", name, word, result, expected );
+                r_errors = r_errors + 1;
+            end
+            r_checked = r_checked + 1;
+        end
+    endtask
+
+    integer word;
+    reg [2:0] r_expected;
+    initial begin
+        @( posedge clk ); #1;
+        r_running = 1'b1;
+        for( word = 0; word < WORDS + LATENCY; word = word + 1 ) begin
+            { r_tx, r_d1, r_d0 } = word < WORDS ? f_Word( word ) : 3'b000;
+            // CLK high, the word of LATENCY clocks before, and the TX of 1 clock before
+            if( word >= 1 && word <= WORDS ) begin
+                r_expected = f_Word( word - 1 );
+                check_bit( "Q1", word - 1, w_q1, r_expected[2] );
+            end
+            if( word >= LATENCY ) begin
+                r_expected = f_Word( word - LATENCY );
+                check_bit( "Q0 high", word - LATENCY, w_q0, r_expected[0] );
+                #5;
+                check_bit( "Q0 low", word - LATENCY, w_q0, r_expected[1] );
+            end
+            @( posedge clk ); #1;
+        end
+        r_running = 1'b0;
+        wait_idle;
+
+        $display( "ODDR: %0d words, %0d checks", WORDS, r_checked );
+        test_bench_finish;
+    end
+endmodule
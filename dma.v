@@ -0,0 +1,538 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	dma.v
+//
+// Project:	dma
+//
+// Purpose:	Scatter gather DMA between a burst memory port and a pair of
+//          streams, memory to stream and stream to memory.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// dma - 2 channels on 1 burst memory port, the ports of 'hyperram_controller' with cmd_register tied to 0
+//  A descriptor is rows + 1 rows of 'length' bytes, row n starts at word address address + n * stride.
+//  Descriptors are queued, 2 ** QUEUE_ADDRESS_WIDTH per channel, and run back to back.
+//  mm2s    memory to stream, m_axis_*. The rows are read in bursts of up to 2 ** LENGTH_WIDTH words and
+//          streamed with tkeep, tlast marks the last word of the descriptor. A burst is only read when
+//          the read buffer, 2 ** READ_ADDRESS_WIDTH words, has room for it, the stream may stall. A burst
+//          that fills the read buffer is closed there and commanded, the row carries on in the next burst.
+//  s2mm    stream to memory, s_axis_*. The stream fills the rows, tkeep bytes inside the row become the write strobes.
+//          The descriptor ends at its last byte or at tlast, whichever is first, a packet longer than the
+//          descriptor carries on into the next one. s2mm_done pulses with the bytes written and whether
+//          tlast ended it.
+// The words are counted 1 per clock, in the order they move. The word address and the row position are
+// counter_chunked counters, the row counter is loaded with ~( words - 1 ) and its registered 'full' flag
+// marks the last word, so neither needs a wide add or compare at the word rate. The byte counts are
+// math_pipelined_accumulators, ALU_WIDTH chunks with registered carries, resolved by a math_pipelined_add
+// of 1 clock per chunk where they are read. A burst is commanded when it is complete, the memory queues
+// the write words until then.
+//  s2mm_done       pulses ceil( ( BYTES_WIDTH + ROWS_WIDTH ) / ALU_WIDTH ) clocks after the descriptor ends,
+//                  the time to resolve s2mm_bytes
+//  *_done_count    descriptors finished
+//  *_byte_count    bytes moved, ceil( COUNTER_WIDTH / ALU_WIDTH ) clocks behind the stream
+// The bytes per word, DATA_WIDTH / 8, MUST BE a power of 2.
+module dma
+    #(
+        parameter ADDRESS_WIDTH         = 22,
+        parameter DATA_WIDTH            = 16,
+        parameter LENGTH_WIDTH          = 7,
+        parameter BYTES_WIDTH           = 16,
+        parameter ROWS_WIDTH            = 8,
+        parameter QUEUE_ADDRESS_WIDTH   = 2,
+        parameter READ_ADDRESS_WIDTH    = 8,
+        parameter ALU_WIDTH             = 8,
+        parameter COUNTER_WIDTH         = 32
+    )
+    (
+        input   wire                            clk,
+        input   wire                            rst,
+        // mm2s descriptors
+        input   wire                            mm2s_desc_valid,
+        output  wire                            mm2s_desc_ready,
+        input   wire    [ADDRESS_WIDTH-1:0]     mm2s_desc_address,
+        input   wire    [BYTES_WIDTH-1:0]       mm2s_desc_length,
+        input   wire    [ADDRESS_WIDTH-1:0]     mm2s_desc_stride,
+        input   wire    [ROWS_WIDTH-1:0]        mm2s_desc_rows,
+        output  wire                            mm2s_done,
+        // mm2s stream
+        output  wire                            m_axis_tvalid,
+        input   wire                            m_axis_tready,
+        output  wire    [DATA_WIDTH-1:0]        m_axis_tdata,
+        output  wire    [DATA_WIDTH/8-1:0]      m_axis_tkeep,
+        output  wire                            m_axis_tlast,
+        // s2mm descriptors
+        input   wire                            s2mm_desc_valid,
+        output  wire                            s2mm_desc_ready,
+        input   wire    [ADDRESS_WIDTH-1:0]     s2mm_desc_address,
+        input   wire    [BYTES_WIDTH-1:0]       s2mm_desc_length,
+        input   wire    [ADDRESS_WIDTH-1:0]     s2mm_desc_stride,
+        input   wire    [ROWS_WIDTH-1:0]        s2mm_desc_rows,
+        output  wire                            s2mm_done,
+        output  wire    [BYTES_WIDTH+ROWS_WIDTH-1:0] s2mm_bytes,
+        output  wire                            s2mm_last,
+        // s2mm stream
+        input   wire                            s_axis_tvalid,
+        output  wire                            s_axis_tready,
+        input   wire    [DATA_WIDTH-1:0]        s_axis_tdata,
+        input   wire    [DATA_WIDTH/8-1:0]      s_axis_tkeep,
+        input   wire                            s_axis_tlast,
+        // burst memory
+        output  wire                            mem_cmd_valid,
+        input   wire                            mem_cmd_ready,
+        output  wire                            mem_cmd_write,
+        output  wire    [ADDRESS_WIDTH-1:0]     mem_cmd_address,
+        output  wire    [LENGTH_WIDTH-1:0]      mem_cmd_length,
+        output  wire                            mem_wr_valid,
+        input   wire                            mem_wr_ready,
+        output  wire    [DATA_WIDTH-1:0]        mem_wr_data,
+        output  wire    [DATA_WIDTH/8-1:0]      mem_wr_strobe,
+        input   wire                            mem_rd_valid,
+        input   wire    [DATA_WIDTH-1:0]        mem_rd_data,
+        // instrumentation
+        output  wire    [COUNTER_WIDTH-1:0]     mm2s_done_count,
+        output  wire    [COUNTER_WIDTH-1:0]     mm2s_byte_count,
+        output  wire    [COUNTER_WIDTH-1:0]     s2mm_done_count,
+        output  wire    [COUNTER_WIDTH-1:0]     s2mm_byte_count
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    localparam BYTES        = DATA_WIDTH / 8;
+    localparam BYTE_SHIFT   = BYTES == 1 ? 0 : f_Log2( BYTES );
+    localparam DESC_WIDTH   = 2 * ADDRESS_WIDTH + BYTES_WIDTH + ROWS_WIDTH;
+    localparam READ_DEPTH   = 1 << READ_ADDRESS_WIDTH;
+    localparam S_BYTES_WIDTH    = BYTES_WIDTH + ROWS_WIDTH;
+    localparam S_BYTES_LATENCY  = ( S_BYTES_WIDTH + ALU_WIDTH - 1 ) / ALU_WIDTH;
+    localparam COUNT_LATENCY    = ( COUNTER_WIDTH + ALU_WIDTH - 1 ) / ALU_WIDTH;
+
+    localparam STATE_IDLE   = 0;
+    localparam STATE_SETUP  = 1;
+    localparam STATE_RUN    = 2;
+    localparam STATE_CMD    = 3;
+
+    // f_Keep - Returns the tkeep of the last word of a row of 'length' bytes
+    function [BYTES-1:0] f_Keep;
+        input [BYTES_WIDTH-1:0] length;
+        integer byte_index;
+        for( byte_index = 0; byte_index < BYTES; byte_index = byte_index + 1 )
+            f_Keep[byte_index] = byte_index <= ( ( length - 1'b1 ) & ( BYTES - 1 ) );
+    endfunction
+    // f_Ones - Returns the number of bytes kept
+    function [BYTE_SHIFT:0] f_Ones;
+        input [BYTES-1:0] keep;
+        integer byte_index;
+        begin
+            f_Ones = 'd0;
+            for( byte_index = 0; byte_index < BYTES; byte_index = byte_index + 1 )
+                f_Ones = f_Ones + keep[byte_index];
+        end
+    endfunction
+
+    // burst memory commands, round robin between the channels
+    wire                        w_mm2s_cmd;
+    wire                        w_s2mm_cmd;
+    reg                         r_last_mm2s     = 0;
+    wire                        w_grant_s2mm    = w_s2mm_cmd && ( !w_mm2s_cmd || r_last_mm2s );
+    wire                        w_grant_mm2s    = w_mm2s_cmd && !w_grant_s2mm;
+    wire                        w_mm2s_taken    = w_grant_mm2s && mem_cmd_ready;
+    wire                        w_s2mm_taken    = w_grant_s2mm && mem_cmd_ready;
+    always @( posedge clk ) begin
+        if( rst )
+            r_last_mm2s <= 1'b0;
+        else if( mem_cmd_valid && mem_cmd_ready )
+            r_last_mm2s <= w_grant_mm2s;
+    end
+
+    ////////////////////////
+    // memory to stream   //
+    ////////////////////////
+    wire                        w_m_desc_valid;
+    wire [ADDRESS_WIDTH-1:0]    w_m_desc_address;
+    wire [BYTES_WIDTH-1:0]      w_m_desc_length;
+    wire [ADDRESS_WIDTH-1:0]    w_m_desc_stride;
+    wire [ROWS_WIDTH-1:0]       w_m_desc_rows;
+    reg  [1:0]                  r_m_state       = STATE_IDLE;
+    fifo_sync #( .WIDTH( DESC_WIDTH ), .ADDRESS_WIDTH( QUEUE_ADDRESS_WIDTH ) ) mm2s_descriptors
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  mm2s_desc_valid ),
+        .in_ready(  mm2s_desc_ready ),
+        .in_data(   { mm2s_desc_address, mm2s_desc_length, mm2s_desc_stride, mm2s_desc_rows } ),
+        .out_valid( w_m_desc_valid ),
+        .out_ready( r_m_state == STATE_IDLE ),
+        .out_data(  { w_m_desc_address, w_m_desc_length, w_m_desc_stride, w_m_desc_rows } ),
+        .count()
+    );
+
+    reg  [ADDRESS_WIDTH-1:0]    r_m_row_address = 0;
+    reg  [BYTES_WIDTH-1:0]      r_m_length      = 0;
+    reg  [ADDRESS_WIDTH-1:0]    r_m_stride      = 0;
+    reg  [ROWS_WIDTH-1:0]       r_m_rows        = 0;    // rows still to start
+    reg  [ADDRESS_WIDTH-1:0]    r_m_burst_start = 0;
+    reg  [LENGTH_WIDTH-1:0]     r_m_burst_words = 0;    // words - 1 of the open burst
+    reg                         r_m_burst_open  = 0;
+    reg                         r_m_row_done    = 0;
+    reg  [READ_ADDRESS_WIDTH:0] r_m_outstanding = 0;    // words counted and not yet streamed
+    wire [ADDRESS_WIDTH-1:0]    w_m_address;
+    wire                        w_m_row_last;
+    wire                        w_m_pop;
+    wire                        w_m_count       = r_m_state == STATE_RUN && r_m_outstanding != READ_DEPTH;
+    wire [LENGTH_WIDTH-1:0]     w_m_burst_words = r_m_burst_open ? r_m_burst_words + 1'b1 : { LENGTH_WIDTH{1'b0} };
+    // the word that fills the read buffer ends the burst, the buffer cannot take a longer one
+    wire                        w_m_buffer_full = r_m_outstanding == READ_DEPTH - 1 && !w_m_pop;
+    wire                        w_m_burst_end   = w_m_row_last || &w_m_burst_words || w_m_buffer_full;
+    assign w_mm2s_cmd = r_m_state == STATE_CMD;
+
+    counter_chunked #( .WIDTH( ADDRESS_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) mm2s_address_counter
+    (
+        .clk(           clk ),
+        .rst(           rst ),
+        .load(          r_m_state == STATE_SETUP ),
+        .load_value(    r_m_row_address ),
+        .enable(        w_m_count ),
+        .count(         w_m_address ),
+        .full()
+    );
+    counter_chunked #( .WIDTH( BYTES_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) mm2s_row_counter
+    (
+        .clk(           clk ),
+        .rst(           rst ),
+        .load(          r_m_state == STATE_SETUP ),
+        .load_value(    ~( ( r_m_length - 1'b1 ) >> BYTE_SHIFT ) ),
+        .enable(        w_m_count ),
+        .count(),
+        .full(          w_m_row_last )
+    );
+
+    always @( posedge clk ) begin
+        r_m_outstanding <= r_m_outstanding + w_m_count - w_m_pop;
+        case( r_m_state )
+            STATE_IDLE: begin
+                if( w_m_desc_valid ) begin
+                    r_m_row_address <= w_m_desc_address;
+                    r_m_length      <= w_m_desc_length;
+                    r_m_stride      <= w_m_desc_stride;
+                    r_m_rows        <= w_m_desc_rows;
+                    r_m_state       <= STATE_SETUP;
+                end
+            end
+            STATE_SETUP: begin
+                r_m_burst_open  <= 1'b0;
+                r_m_state       <= STATE_RUN;
+            end
+            STATE_RUN: begin
+                if( w_m_count ) begin
+                    r_m_burst_open  <= 1'b1;
+                    r_m_burst_words <= w_m_burst_words;
+                    if( !r_m_burst_open )
+                        r_m_burst_start <= w_m_address;
+                    r_m_row_done    <= w_m_row_last;
+                    if( w_m_burst_end )
+                        r_m_state   <= STATE_CMD;
+                end
+            end
+            default: begin
+                if( w_mm2s_taken ) begin
+                    r_m_burst_open  <= 1'b0;
+                    if( !r_m_row_done ) begin
+                        r_m_state   <= STATE_RUN;
+                    end else if( r_m_rows != 0 ) begin
+                        r_m_row_address <= r_m_row_address + r_m_stride;
+                        r_m_rows        <= r_m_rows - 1'b1;
+                        r_m_state       <= STATE_SETUP;
+                    end else begin
+                        r_m_state   <= STATE_IDLE;
+                    end
+                end
+            end
+        endcase
+        if( rst ) begin
+            r_m_state       <= STATE_IDLE;
+            r_m_outstanding <= 'd0;
+        end
+    end
+
+    // the tkeep and tlast of every word counted, in step with the words read
+    wire                        w_m_data_valid;
+    wire [BYTES-1:0]            w_m_keep;
+    wire                        w_m_last;
+    fifo_sync #( .WIDTH( 1 + BYTES ), .ADDRESS_WIDTH( READ_ADDRESS_WIDTH ) ) mm2s_flags
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  w_m_count ),
+        .in_ready(),
+        .in_data(   { w_m_row_last && r_m_rows == 0, w_m_row_last ? f_Keep( r_m_length ) : { BYTES{1'b1} } } ),
+        .out_valid(),
+        .out_ready( w_m_pop ),
+        .out_data(  { w_m_last, w_m_keep } ),
+        .count()
+    );
+    fifo_sync #( .WIDTH( DATA_WIDTH ), .ADDRESS_WIDTH( READ_ADDRESS_WIDTH ) ) mm2s_read_buffer
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  mem_rd_valid ),
+        .in_ready(),
+        .in_data(   mem_rd_data ),
+        .out_valid( w_m_data_valid ),
+        .out_ready( w_m_pop ),
+        .out_data(  m_axis_tdata ),
+        .count()
+    );
+    assign m_axis_tvalid    = w_m_data_valid;
+    assign m_axis_tkeep     = w_m_keep;
+    assign m_axis_tlast     = w_m_last;
+    assign w_m_pop          = m_axis_tvalid && m_axis_tready;
+    assign mm2s_done        = w_m_pop && w_m_last;
+
+    ////////////////////////
+    // stream to memory   //
+    ////////////////////////
+    wire                        w_s_desc_valid;
+    wire [ADDRESS_WIDTH-1:0]    w_s_desc_address;
+    wire [BYTES_WIDTH-1:0]      w_s_desc_length;
+    wire [ADDRESS_WIDTH-1:0]    w_s_desc_stride;
+    wire [ROWS_WIDTH-1:0]       w_s_desc_rows;
+    reg  [1:0]                  r_s_state       = STATE_IDLE;
+    fifo_sync #( .WIDTH( DESC_WIDTH ), .ADDRESS_WIDTH( QUEUE_ADDRESS_WIDTH ) ) s2mm_descriptors
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  s2mm_desc_valid ),
+        .in_ready(  s2mm_desc_ready ),
+        .in_data(   { s2mm_desc_address, s2mm_desc_length, s2mm_desc_stride, s2mm_desc_rows } ),
+        .out_valid( w_s_desc_valid ),
+        .out_ready( r_s_state == STATE_IDLE ),
+        .out_data(  { w_s_desc_address, w_s_desc_length, w_s_desc_stride, w_s_desc_rows } ),
+        .count()
+    );
+
+    reg  [ADDRESS_WIDTH-1:0]    r_s_row_address = 0;
+    reg  [BYTES_WIDTH-1:0]      r_s_length      = 0;
+    reg  [ADDRESS_WIDTH-1:0]    r_s_stride      = 0;
+    reg  [ROWS_WIDTH-1:0]       r_s_rows        = 0;
+    reg  [ADDRESS_WIDTH-1:0]    r_s_burst_start = 0;
+    reg  [LENGTH_WIDTH-1:0]     r_s_burst_words = 0;
+    reg                         r_s_burst_open  = 0;
+    reg                         r_s_row_done    = 0;
+    reg                         r_s_tlast       = 0;
+    reg                         r_s_done        = 0;
+    reg  [S_BYTES_WIDTH-1:0]    r_s_done_sum    = 0;
+    reg  [S_BYTES_WIDTH-1:0]    r_s_done_carries = 0;
+    reg                         r_s_done_last   = 0;
+    wire [S_BYTES_WIDTH-1:0]    w_s_bytes_sum;      // bytes of the descriptor so far, sum + carries
+    wire [S_BYTES_WIDTH-1:0]    w_s_bytes_carries;
+    wire [ADDRESS_WIDTH-1:0]    w_s_address;
+    wire                        w_s_row_last;
+    assign s_axis_tready = r_s_state == STATE_RUN && mem_wr_ready;
+    wire                        w_s_count       = s_axis_tvalid && s_axis_tready;
+    wire [LENGTH_WIDTH-1:0]     w_s_burst_words = r_s_burst_open ? r_s_burst_words + 1'b1 : { LENGTH_WIDTH{1'b0} };
+    wire                        w_s_burst_end   = w_s_row_last || s_axis_tlast || &w_s_burst_words;
+    // the last word of a row only writes the bytes inside the row, the same as the mm2s tkeep
+    wire [BYTES-1:0]            w_s_keep        = w_s_row_last ? s_axis_tkeep & f_Keep( r_s_length ) : s_axis_tkeep;
+    assign w_s2mm_cmd       = r_s_state == STATE_CMD;
+    assign mem_wr_valid     = w_s_count;
+    assign mem_wr_data      = s_axis_tdata;
+    assign mem_wr_strobe    = w_s_keep;
+
+    math_pipelined_accumulator #( .WIDTH( S_BYTES_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) s2mm_desc_bytes_accumulator
+    (
+        .clk(           clk ),
+        .clear(         r_s_state == STATE_IDLE ),
+        .enable(        w_s_count ),
+        .restart(       1'b0 ),
+        .I1(            { { S_BYTES_WIDTH-BYTE_SHIFT-1{1'b0} }, f_Ones( w_s_keep ) } ),
+        .next_sum(),
+        .next_carries(),
+        .sum(           w_s_bytes_sum ),
+        .carries(       w_s_bytes_carries )
+    );
+    // the descriptor's bytes are resolved after it ends, done and last wait for them
+    math_pipelined_add #( .WIDTH( S_BYTES_WIDTH ), .LATENCY( S_BYTES_LATENCY ) ) s2mm_desc_bytes_add
+    (
+        .clk(   clk ),
+        .I1(    r_s_done_sum ),
+        .I2(    r_s_done_carries ),
+        .cin(   1'b0 ),
+        .sum(   s2mm_bytes ),
+        .cout()
+    );
+    ff_delay #( .WIDTH( 2 ), .DEPTH( S_BYTES_LATENCY ) ) s2mm_done_delay
+    (
+        .clk(   clk ),
+        .D(     { r_s_done, r_s_done_last } ),
+        .Q(     { s2mm_done, s2mm_last } )
+    );
+
+    counter_chunked #( .WIDTH( ADDRESS_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) s2mm_address_counter
+    (
+        .clk(           clk ),
+        .rst(           rst ),
+        .load(          r_s_state == STATE_SETUP ),
+        .load_value(    r_s_row_address ),
+        .enable(        w_s_count ),
+        .count(         w_s_address ),
+        .full()
+    );
+    counter_chunked #( .WIDTH( BYTES_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) s2mm_row_counter
+    (
+        .clk(           clk ),
+        .rst(           rst ),
+        .load(          r_s_state == STATE_SETUP ),
+        .load_value(    ~( ( r_s_length - 1'b1 ) >> BYTE_SHIFT ) ),
+        .enable(        w_s_count ),
+        .count(),
+        .full(          w_s_row_last )
+    );
+
+    always @( posedge clk ) begin
+        r_s_done <= 1'b0;
+        case( r_s_state )
+            STATE_IDLE: begin
+                if( w_s_desc_valid ) begin
+                    r_s_row_address <= w_s_desc_address;
+                    r_s_length      <= w_s_desc_length;
+                    r_s_stride      <= w_s_desc_stride;
+                    r_s_rows        <= w_s_desc_rows;
+                    r_s_state       <= STATE_SETUP;
+                end
+            end
+            STATE_SETUP: begin
+                r_s_burst_open  <= 1'b0;
+                r_s_state       <= STATE_RUN;
+            end
+            STATE_RUN: begin
+                if( w_s_count ) begin
+                    r_s_burst_open  <= 1'b1;
+                    r_s_burst_words <= w_s_burst_words;
+                    if( !r_s_burst_open )
+                        r_s_burst_start <= w_s_address;
+                    r_s_row_done    <= w_s_row_last;
+                    r_s_tlast       <= s_axis_tlast;
+                    if( w_s_burst_end )
+                        r_s_state   <= STATE_CMD;
+                end
+            end
+            default: begin
+                if( w_s2mm_taken ) begin
+                    r_s_burst_open  <= 1'b0;
+                    if( !r_s_row_done && !r_s_tlast ) begin
+                        r_s_state   <= STATE_RUN;
+                    end else if( r_s_rows != 0 && !r_s_tlast ) begin
+                        r_s_row_address <= r_s_row_address + r_s_stride;
+                        r_s_rows        <= r_s_rows - 1'b1;
+                        r_s_state       <= STATE_SETUP;
+                    end else begin
+                        r_s_done        <= 1'b1;
+                        r_s_done_sum    <= w_s_bytes_sum;
+                        r_s_done_carries <= w_s_bytes_carries;
+                        r_s_done_last   <= r_s_tlast;
+                        r_s_state       <= STATE_IDLE;
+                    end
+                end
+            end
+        endcase
+        if( rst ) begin
+            r_s_state   <= STATE_IDLE;
+            r_s_done    <= 1'b0;
+        end
+    end
+
+    // the memory command of the granted channel, its burst ends at the current word
+    assign mem_cmd_valid    = w_mm2s_cmd || w_s2mm_cmd;
+    assign mem_cmd_write    = w_grant_s2mm;
+    assign mem_cmd_address  = w_grant_s2mm ? r_s_burst_start : r_m_burst_start;
+    assign mem_cmd_length   = w_grant_s2mm ? r_s_burst_words : r_m_burst_words;
+
+    // instrumentation, the byte counts are resolved on their way out
+    wire [COUNTER_WIDTH-1:0] w_mm2s_bytes_sum;
+    wire [COUNTER_WIDTH-1:0] w_mm2s_bytes_carries;
+    wire [COUNTER_WIDTH-1:0] w_s2mm_bytes_sum;
+    wire [COUNTER_WIDTH-1:0] w_s2mm_bytes_carries;
+    math_pipelined_accumulator #( .WIDTH( COUNTER_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) mm2s_bytes_accumulator
+    (
+        .clk(           clk ),
+        .clear(         rst ),
+        .enable(        w_m_pop ),
+        .restart(       1'b0 ),
+        .I1(            { { COUNTER_WIDTH-BYTE_SHIFT-1{1'b0} }, f_Ones( m_axis_tkeep ) } ),
+        .next_sum(),
+        .next_carries(),
+        .sum(           w_mm2s_bytes_sum ),
+        .carries(       w_mm2s_bytes_carries )
+    );
+    math_pipelined_add #( .WIDTH( COUNTER_WIDTH ), .LATENCY( COUNT_LATENCY ) ) mm2s_bytes_add
+    (
+        .clk(   clk ),
+        .I1(    w_mm2s_bytes_sum ),
+        .I2(    w_mm2s_bytes_carries ),
+        .cin(   1'b0 ),
+        .sum(   mm2s_byte_count ),
+        .cout()
+    );
+    math_pipelined_accumulator #( .WIDTH( COUNTER_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) s2mm_bytes_accumulator
+    (
+        .clk(           clk ),
+        .clear(         rst ),
+        .enable(        w_s_count ),
+        .restart(       1'b0 ),
+        .I1(            { { COUNTER_WIDTH-BYTE_SHIFT-1{1'b0} }, f_Ones( w_s_keep ) } ),
+        .next_sum(),
+        .next_carries(),
+        .sum(           w_s2mm_bytes_sum ),
+        .carries(       w_s2mm_bytes_carries )
+    );
+    math_pipelined_add #( .WIDTH( COUNTER_WIDTH ), .LATENCY( COUNT_LATENCY ) ) s2mm_bytes_add
+    (
+        .clk(   clk ),
+        .I1(    w_s2mm_bytes_sum ),
+        .I2(    w_s2mm_bytes_carries ),
+        .cin(   1'b0 ),
+        .sum(   s2mm_byte_count ),
+        .cout()
+    );
+    counter_chunked #( .WIDTH( COUNTER_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) mm2s_done_counter
+    (
+        .clk(           clk ),
+        .rst(           rst ),
+        .load(          1'b0 ),
+        .load_value(    { COUNTER_WIDTH{1'b0} } ),
+        .enable(        mm2s_done ),
+        .count(         mm2s_done_count ),
+        .full()
+    );
+    counter_chunked #( .WIDTH( COUNTER_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) s2mm_done_counter
+    (
+        .clk(           clk ),
+        .rst(           rst ),
+        .load(          1'b0 ),
+        .load_value(    { COUNTER_WIDTH{1'b0} } ),
+        .enable(        s2mm_done ),
+        .count(         s2mm_done_count ),
+        .full()
+    );
+endmodule
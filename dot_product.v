@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	dot_product.v
+//
+// Project:	dot product
+//
+// Purpose:	Pipelined N element dot product, 1 per clock, with an optional
+//          accumulate mode for vectors longer than N.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// dot_product - result = I1[0] * I2[0] + I1[1] * I2[1] + ... + I1[N-1] * I2[N-1]
+//  element n is I1[n*A_WIDTH+:A_WIDTH] and I2[n*B_WIDTH+:B_WIDTH]
+//  SUM_WIDTH MUST BE > A_WIDTH + B_WIDTH, N products need log2( N ) bits of growth
+//  ACCUMULATE
+//      0:  every in_valid is a complete vector, in_first and in_last are ignored.
+//          result is valid LATENCY = MULT_LATENCY + TREE_LATENCY clocks after in_valid
+//      1:  a vector is several N element slices, in_first marks the first slice and in_last the
+//          last. Slices may be back to back, the next vector can start the clock after in_last.
+//          The running sum is a math_pipelined_accumulator, ALU_WIDTH chunks with registered carries,
+//          the same as the 'systolic_array' cells, and is resolved by a math_pipelined_add after the last slice.
+//          result is valid LATENCY = MULT_LATENCY + TREE_LATENCY + 1 + ADD_LATENCY clocks after in_last
+//
+// The N products of math_pipelined_multiply feed a math_pipelined_adder_tree, whose N-ary geometry
+// is picked by the f_NaryRecursion functions to fit in TREE_LATENCY.
+module dot_product
+    #(
+        parameter N             = 8,
+        parameter A_WIDTH       = 16,
+        parameter B_WIDTH       = 16,
+        parameter SUM_WIDTH     = 40,
+        parameter SIGNED        = 1,
+        parameter MULT_LATENCY  = 2,
+        parameter TREE_LATENCY  = 2,
+        parameter ACCUMULATE    = 0,
+        parameter ALU_WIDTH     = 8,
+        parameter ADD_LATENCY   = 2,
+        parameter DSP           = 1
+    )
+    (
+        input   wire                        clk,
+        input   wire                        rst,
+        input   wire                        in_valid,
+        input   wire                        in_first,
+        input   wire                        in_last,
+        input   wire    [N*A_WIDTH-1:0]     I1,
+        input   wire    [N*B_WIDTH-1:0]     I2,
+        output  wire                        out_valid,
+        output  wire    [SUM_WIDTH-1:0]     result
+    );
+    localparam PRODUCT_WIDTH    = A_WIDTH + B_WIDTH;
+    localparam CHUNK_COUNT      = SUM_WIDTH % ALU_WIDTH == 0 ? SUM_WIDTH / ALU_WIDTH : SUM_WIDTH / ALU_WIDTH + 1;
+
+    // products, extended to the sum width
+    wire [N*SUM_WIDTH-1:0] w_products;
+    genvar idx;
+    generate
+        for( idx = 0; idx < N; idx = idx + 1 ) begin : dot_multiply_loop
+            wire [PRODUCT_WIDTH-1:0] w_product;
+            math_pipelined_multiply #( .WIDTH_A( A_WIDTH ), .WIDTH_B( B_WIDTH ), .LATENCY( MULT_LATENCY ), .SIGNED( SIGNED ), .DSP( DSP ) ) element_multiply
+            (
+                .clk(       clk ),
+                .I1(        I1[idx*A_WIDTH+:A_WIDTH] ),
+                .I2(        I2[idx*B_WIDTH+:B_WIDTH] ),
+                .product(   w_product )
+            );
+            assign w_products[idx*SUM_WIDTH+:SUM_WIDTH] = { { (SUM_WIDTH-PRODUCT_WIDTH){ SIGNED ? w_product[PRODUCT_WIDTH-1] : 1'b0 } }, w_product };
+        end
+    endgenerate
+
+    wire [SUM_WIDTH-1:0] w_dot;
+    math_pipelined_adder_tree #( .WIDTH( SUM_WIDTH ), .COUNT( N ), .LATENCY( TREE_LATENCY ) ) dot_tree
+    (
+        .clk(   clk ),
+        .I1(    w_products ),
+        .sum(   w_dot )
+    );
+
+    // the flags follow the products through the tree
+    wire w_valid;
+    wire w_first;
+    wire w_last;
+    ff_delay #( .WIDTH( 3 ), .DEPTH( MULT_LATENCY + TREE_LATENCY ) ) flag_delay
+    (
+        .clk(   clk ),
+        .D(     { in_last, in_first, in_valid } ),
+        .Q(     { w_last, w_first, w_valid } )
+    );
+
+    generate
+        if( ACCUMULATE == 0 ) begin
+            assign result       = w_dot;
+            assign out_valid    = w_valid;
+        end else begin
+            // chunked accumulator, { carries, sum }
+            wire [SUM_WIDTH-1:0]    w_sum;
+            wire [CHUNK_COUNT-1:0]  w_carries;
+            math_pipelined_accumulator #( .WIDTH( SUM_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) dot_accumulator
+            (
+                .clk(           clk ),
+                .clear(         1'b0 ),
+                .enable(        w_valid ),
+                .restart(       w_first ),
+                .I1(            w_dot ),
+                .next_sum(      w_sum ),
+                .next_carries(  w_carries ),
+                .sum(),
+                .carries()
+            );
+            reg  [SUM_WIDTH-1:0]    r_hold_sum      = 0;
+            reg  [CHUNK_COUNT-1:0]  r_hold_carries  = 0;
+            reg                     r_hold_valid    = 0;
+            wire [SUM_WIDTH-1:0]    w_hold_carries;
+            // the carry out of chunk idx belongs to the lsb of chunk idx + 1, the top carry is dropped
+            for( idx = 0; idx < SUM_WIDTH; idx = idx + 1 ) begin : carry_position_loop
+                if( idx % ALU_WIDTH == 0 && idx != 0 )
+                    assign w_hold_carries[idx] = r_hold_carries[idx/ALU_WIDTH-1];
+                else
+                    assign w_hold_carries[idx] = 1'b0;
+            end
+            always @( posedge clk ) begin
+                if( w_valid && w_last ) begin
+                    r_hold_sum      <= w_sum;
+                    r_hold_carries  <= w_carries;
+                end
+                if( rst )
+                    r_hold_valid    <= 1'b0;
+                else
+                    r_hold_valid    <= w_valid && w_last;
+            end
+            math_pipelined_add #( .WIDTH( SUM_WIDTH ), .LATENCY( ADD_LATENCY ) ) resolve_add
+            (
+                .clk(   clk ),
+                .I1(    r_hold_sum ),
+                .I2(    w_hold_carries ),
+                .cin(   1'b0 ),
+                .sum(   result ),
+                .cout()
+            );
+            ff_delay #( .WIDTH( 1 ), .DEPTH( ADD_LATENCY ) ) valid_delay ( .clk( clk ), .D( r_hold_valid ), .Q( out_valid ) );
+        end
+    endgenerate
+endmodule
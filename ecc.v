@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	ecc.v
+//
+// Project:	hamming secded ecc
+//
+// Purpose:	Single error correcting, double error detecting encoder and decoder
+//          with pipelined parity trees. 1 code word per clock.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// ecc_secded_encoder - code_word = { overall_parity, check[PARITY_BITS-1:0], I1 }
+//  DATA_WIDTH  8 16 32 64 128 256
+//  CODE_WIDTH 13 22 39 72 137 266
+// Every parity bit is its own 'math_pipelined_reduce' xor tree over the masked data,
+// the masks are built at elaboration time so the unused inputs are optimized away.
+// code_word is valid exactly 'LATENCY' clocks after I1.
+module ecc_secded_encoder
+    #(
+        parameter DATA_WIDTH    = 32,
+        parameter LATENCY       = 2
+    )
+    (
+        clk, I1, code_word
+    );
+    `ifndef FORMAL
+        `include "./toolbox/ecc_functions.v"
+    `else
+        `include "ecc_functions.v"
+    `endif
+    localparam PARITY_BITS  = f_EccParityBits( DATA_WIDTH );
+    localparam CODE_WIDTH   = DATA_WIDTH + PARITY_BITS + 1;
+
+    input   wire                    clk;
+    input   wire [DATA_WIDTH-1:0]   I1;
+    output  wire [CODE_WIDTH-1:0]   code_word;
+
+    genvar check_index;
+    genvar data_index;
+    generate
+        // check bits, and the overall parity bit when check_index == PARITY_BITS
+        for( check_index = 0; check_index <= PARITY_BITS; check_index = check_index + 1 ) begin : ecc_check_loop
+            wire [DATA_WIDTH-1:0] w_mask;
+            for( data_index = 0; data_index < DATA_WIDTH; data_index = data_index + 1 ) begin : ecc_mask_loop
+                assign w_mask[data_index] = f_EccParityMask( data_index, check_index, PARITY_BITS );
+            end
+            math_pipelined_reduce #( .WIDTH( DATA_WIDTH ), .LATENCY( LATENCY ), .OPERATION( "XOR" ) ) parity_tree
+            (
+                .clk(       clk ),
+                .I1(        I1 & w_mask ),
+                .result(    code_word[DATA_WIDTH+check_index] )
+            );
+        end
+    endgenerate
+    ff_delay #( .WIDTH( DATA_WIDTH ), .DEPTH( LATENCY ) ) data_delay ( .clk( clk ), .D( I1 ), .Q( code_word[DATA_WIDTH-1:0] ) );
+endmodule
+
+// ecc_secded_decoder - data = corrected I1[DATA_WIDTH-1:0]
+//  The parity of the received data is rebuilt with 'ecc_secded_encoder', the syndrome is
+//  the rebuilt check bits xor the received check bits. The syndrome and the correction are
+//  done in a single stage after the parity trees, the outputs are valid 'LATENCY' + 1 clocks after I1.
+//      syndrome == 0, parity ok            no error
+//      parity error                        single error, corrected. syndrome is the bit position
+//      syndrome != 0, parity ok            double error, data is passed through uncorrected
+module ecc_secded_decoder
+    #(
+        parameter DATA_WIDTH    = 32,
+        parameter LATENCY       = 2
+    )
+    (
+        clk, I1, data, single_error, double_error
+    );
+    `ifndef FORMAL
+        `include "./toolbox/ecc_functions.v"
+    `else
+        `include "ecc_functions.v"
+    `endif
+    localparam PARITY_BITS  = f_EccParityBits( DATA_WIDTH );
+    localparam CODE_WIDTH   = DATA_WIDTH + PARITY_BITS + 1;
+
+    input   wire                    clk;
+    input   wire [CODE_WIDTH-1:0]   I1;
+    output  wire [DATA_WIDTH-1:0]   data;
+    output  wire                    single_error;
+    output  wire                    double_error;
+
+    // rebuild the parity of the received data
+    wire [CODE_WIDTH-1:0]   w_rebuilt;
+    ecc_secded_encoder #( .DATA_WIDTH( DATA_WIDTH ), .LATENCY( LATENCY ) ) rebuild
+    (
+        .clk(       clk ),
+        .I1(        I1[DATA_WIDTH-1:0] ),
+        .code_word( w_rebuilt )
+    );
+    // the received parity bits, aligned with the rebuilt parity
+    wire [PARITY_BITS:0]    w_received;
+    ff_delay #( .WIDTH( PARITY_BITS + 1 ), .DEPTH( LATENCY ) ) parity_delay ( .clk( clk ), .D( I1[CODE_WIDTH-1:DATA_WIDTH] ), .Q( w_received ) );
+
+    wire [PARITY_BITS-1:0]  w_syndrome      = w_rebuilt[DATA_WIDTH+:PARITY_BITS] ^ w_received[PARITY_BITS-1:0];
+    // the rebuilt overall parity only covers the rebuilt check bits, swap them for the received ones
+    wire                    w_parity_error  = w_rebuilt[CODE_WIDTH-1] ^ w_received[PARITY_BITS] ^ (^w_syndrome);
+
+    reg [DATA_WIDTH-1:0]    r_data          = 0;
+    reg                     r_single_error  = 0;
+    reg                     r_double_error  = 0;
+    assign data         = r_data;
+    assign single_error = r_single_error;
+    assign double_error = r_double_error;
+
+    genvar data_index;
+    generate
+        for( data_index = 0; data_index < DATA_WIDTH; data_index = data_index + 1 ) begin : ecc_correct_loop
+            localparam [PARITY_BITS-1:0] POSITION = f_EccDataPosition( data_index );
+            always @( posedge clk ) r_data[data_index] <= w_rebuilt[data_index] ^ (w_parity_error && w_syndrome == POSITION);
+        end
+    endgenerate
+    always @( posedge clk ) begin
+        r_single_error <= w_parity_error;
+        r_double_error <= !w_parity_error && w_syndrome != 0;
+    end
+endmodule
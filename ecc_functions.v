@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	ecc_functions.v
+//
+// Project:	hamming secded ecc
+//
+// Purpose:	functions used to build the parity matrix of the ecc modules.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////
+// Hamming code layout                        //
+// f_EccParityBits                            //
+// f_EccDataPosition                          //
+// f_EccParityMask                            //
+//
+// The code word is stored systematically as { overall_parity, check[PARITY_BITS-1:0], data }
+// The parity matrix is built from the classic hamming positions. Position 1 is the first bit,
+// check bit 'n' sits at position 2**n and the data bits fill the remaining positions in order.
+//  position    1   2   3   4   5   6   7   8   9   10  11  12
+//              c0  c1  d0  c2  d1  d2  d3  c3  d4  d5  d6  d7
+// Check bit 'n' covers every data bit whose position has bit 'n' set. The syndrome of a single
+// bit error is the position of the flipped bit.
+
+//  f_EccParityBits - Returns the number of hamming check bits needed, not counting the overall parity bit
+//  data_width  - Number of data bits protected
+function automatic integer f_EccParityBits;
+    input integer data_width;
+    for( f_EccParityBits = 1; (1 << f_EccParityBits) < data_width + f_EccParityBits + 1; f_EccParityBits = f_EccParityBits + 1 ) begin end
+endfunction
+
+//  f_EccDataPosition - Returns the hamming position of a data bit
+//  data_index  - data bit to find
+function automatic integer f_EccDataPosition;
+    input integer data_index;
+    integer position;
+    begin
+        f_EccDataPosition = 0;
+        for( position = 3; data_index >= 0; position = position + 1 ) begin
+            // skip the check bit positions, powers of 2
+            if( (position & (position - 1)) != 0 ) begin
+                if( data_index == 0 )
+                    f_EccDataPosition = position;
+                data_index = data_index - 1;
+            end
+        end
+    end
+endfunction
+
+//  f_EccParityMask - Returns a bit of the data mask used to build a check bit
+//  data_index  - data bit
+//  check_index - check bit, check_index == parity_bits is the overall parity bit
+//  parity_bits - value returned by f_EccParityBits
+//
+//  The overall parity bit covers the data and the check bits. A data bit is included in
+//  1 + popcount(position) of those terms, so only data bits with an even popcount position
+//  are left once the check bits are expanded. This lets all of the parity bits be built in parallel.
+function automatic f_EccParityMask;
+    input integer data_index, check_index, parity_bits;
+    integer position, ones, idx;
+    begin
+        position = f_EccDataPosition( data_index );
+        if( check_index < parity_bits ) begin
+            f_EccParityMask = (position >> check_index) & 1;
+        end else begin
+            ones = 0;
+            for( idx = 0; idx < parity_bits; idx = idx + 1 )
+                ones = ones + ((position >> idx) & 1);
+            f_EccParityMask = (ones & 1) == 0;
+        end
+    end
+endfunction
@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	fifo.v
+//
+// Project:	fifo
+//
+// Purpose:	Synchronous first word fall through fifo with valid / ready
+//          handshakes on both sides.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// fifo_sync - 2 ** ADDRESS_WIDTH words of 'WIDTH' bits
+//  A word is written on the clock in_valid and in_ready are set and read on the clock out_valid and
+//  out_ready are set. out_data shows the oldest word whenever out_valid is set, first word fall through,
+//  so a word written on clock n can be read on clock n + 1. Writing and reading on the same clock works
+//  when full. 'count' is the number of words held.
+//  The storage is shadow sram with an asynchronous read.
+module fifo_sync
+    #(
+        parameter WIDTH         = 8,
+        parameter ADDRESS_WIDTH = 4
+    )
+    (
+        input   wire                        clk,
+        input   wire                        rst,
+        input   wire                        in_valid,
+        output  wire                        in_ready,
+        input   wire    [WIDTH-1:0]         in_data,
+        output  wire                        out_valid,
+        input   wire                        out_ready,
+        output  wire    [WIDTH-1:0]         out_data,
+        output  wire    [ADDRESS_WIDTH:0]   count
+    );
+    localparam DEPTH = 1 << ADDRESS_WIDTH;
+
+    // the pointers have an extra bit to tell full from empty
+    reg [ADDRESS_WIDTH:0]   r_write = 0;
+    reg [ADDRESS_WIDTH:0]   r_read  = 0;
+    (* syn_ramstyle = "distributed_ram" *) reg [WIDTH-1:0] r_memory [0:DEPTH-1];
+
+    wire [ADDRESS_WIDTH:0]  w_count = r_write - r_read;
+    wire                    w_push  = in_valid && in_ready;
+    wire                    w_pop   = out_valid && out_ready;
+    assign in_ready     = w_count != DEPTH || out_ready;
+    assign out_valid    = w_count != 0;
+    assign out_data     = r_memory[r_read[ADDRESS_WIDTH-1:0]];
+    assign count        = w_count;
+
+    always @( posedge clk ) begin
+        if( w_push )
+            r_memory[r_write[ADDRESS_WIDTH-1:0]] <= in_data;
+        if( rst ) begin
+            r_write <= 'd0;
+            r_read  <= 'd0;
+        end else begin
+            if( w_push )
+                r_write <= r_write + 1'b1;
+            if( w_pop )
+                r_read  <= r_read + 1'b1;
+        end
+    end
+endmodule
@@ -35,4 +35,32 @@ module ff_dffre
 `endif
 
 
-endmodule
\ No newline at end of file
+endmodule
+
+// A simple register delay line. Used to keep side band data aligned with a pipelined datapath
+// DEPTH = 0 is a pass through wire
+module ff_delay
+    #(
+        parameter WIDTH = 1,
+        parameter DEPTH = 1,
+        parameter INIT  = 1'b0
+    )
+    (
+        input   wire                clk,
+        input   wire    [WIDTH-1:0] D,
+        output  wire    [WIDTH-1:0] Q
+    );
+    generate
+        if( DEPTH == 0 ) begin
+            assign Q = D;
+        end else begin
+            reg [WIDTH*DEPTH-1:0] r_delay = { (WIDTH*DEPTH){INIT} };
+            assign Q = r_delay[WIDTH*DEPTH-1-:WIDTH];
+            if( DEPTH == 1 ) begin
+                always @( posedge clk ) r_delay <= D;
+            end else begin
+                always @( posedge clk ) r_delay <= { r_delay[WIDTH*(DEPTH-1)-1:0], D };
+            end
+        end
+    endgenerate
+endmodule
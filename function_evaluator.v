@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	function_evaluator.v
+//
+// Project:	function evaluator
+//
+// Purpose:	Pipelined piecewise polynomial approximation of exp2, log2,
+//          reciprocal and square root in fixed point. 1 result per clock.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// function_evaluator - result = f( I1 )
+//  I1 is an unsigned fraction, x = I1 / 2**IN_WIDTH, 0 <= x < 1
+//  result is unsigned with 1 integer bit, result / 2**(OUT_WIDTH-1)
+//  FUNCTION
+//      "EXP2"          2**x            [1, 2)
+//      "LOG2"          log2(1 + x)     [0, 1)
+//      "RECIPROCAL"    1 / (1 + x)     (0.5, 1]
+//      "SQRT"          sqrt(1 + x)     [1, 1.42)
+//  Inputs outside these ranges are range reduced by the caller, shifting the exponent.
+//
+// The top 'SEGMENT_BITS' of I1 select a segment from the coefficient rom, the remaining bits 'u'
+// are the offset in the segment. The segment polynomial is evaluated with horner's scheme,
+// each step is a 'math_pipelined_multiply' followed by a 'math_pipelined_add'.
+//  p(u) = ((c3 * u + c2) * u + c1) * u + c0
+// The coefficients are generated at elaboration time by interpolating f() at the chebyshev
+// nodes of each segment, for DEGREE 1 to 3. Coefficients have OUT_WIDTH - 1 + GUARD_BITS
+// fraction bits, the rounding of the result is folded into c0.
+// result is valid LATENCY = DEGREE * ( MULT_LATENCY + ADD_LATENCY ) + 2 clocks after I1.
+//
+// Maximum error in result ulps, every input tested against f() in real arithmetic. The second row
+// is the default parameters, function_evaluator_tb.v with a row's parameters reports its entries.
+//  IN_WIDTH OUT_WIDTH SEGMENT_BITS DEGREE GUARD_BITS   EXP2    LOG2    RECIPROCAL  SQRT
+//  12       13        5            1      3            0.75    0.88    0.94        0.61
+//  16       17        6            2      4            0.61    0.60    0.60        0.59
+//  16       17        4            3      4            0.67    0.66    0.63        0.67
+//  20       21        7            2      4            0.64    0.61    0.61        0.62
+module function_evaluator
+    #(
+        parameter FUNCTION      = "EXP2",
+        parameter IN_WIDTH      = 16,
+        parameter OUT_WIDTH     = 17,
+        parameter SEGMENT_BITS  = 6,
+        parameter DEGREE        = 2,
+        parameter GUARD_BITS    = 4,
+        parameter MULT_LATENCY  = 2,
+        parameter ADD_LATENCY   = 1,
+        parameter DSP           = 1
+    )
+    (
+        input   wire                    clk,
+        input   wire    [IN_WIDTH-1:0]  I1,
+        output  wire    [OUT_WIDTH-1:0] result
+    );
+    localparam U_BITS       = IN_WIDTH - SEGMENT_BITS;
+    localparam COEF_FRAC    = OUT_WIDTH - 1 + GUARD_BITS;
+    localparam COEF_WIDTH   = COEF_FRAC + 3;    // sign and 2 integer bits, MUST BE <= 32
+    localparam STEP_LATENCY = MULT_LATENCY + ADD_LATENCY;
+    localparam LATENCY      = DEGREE * STEP_LATENCY + 2;
+
+    // f_FunctionValue - Returns f( x )
+    function real f_FunctionValue;
+        input real x;
+        begin
+            if( FUNCTION == "EXP2" )
+                f_FunctionValue = $pow( 2.0, x );
+            else if( FUNCTION == "LOG2" )
+                f_FunctionValue = $ln( 1.0 + x ) / $ln( 2.0 );
+            else if( FUNCTION == "RECIPROCAL" )
+                f_FunctionValue = 1.0 / ( 1.0 + x );
+            else
+                f_FunctionValue = $sqrt( 1.0 + x );
+        end
+    endfunction
+    // f_SegmentValue - Returns f() at 'v' from the center of the segment, -0.5 <= v <= 0.5
+    function real f_SegmentValue;
+        input integer segment;
+        input real v;
+        f_SegmentValue = f_FunctionValue( ( segment + 0.5 + v ) / $pow( 2.0, SEGMENT_BITS ) );
+    endfunction
+    // f_Coefficient - Returns coefficient 'term' of the segment polynomial in fixed point.
+    //  The polynomial is first built around the segment center 'v' using the symmetric chebyshev nodes
+    //  +-d, then moved to the segment start, u = v + 0.5
+    function integer f_Coefficient;
+        input integer segment, term;
+        real d, d1, d2, e1, e2, o1, o2, a0, a1, a2, a3, b;
+        begin
+            a2 = 0.0;
+            a3 = 0.0;
+            if( DEGREE == 1 ) begin
+                d   = 0.5 * $cos( 3.14159265358979 / 4.0 );
+                a0  = ( f_SegmentValue( segment, d ) + f_SegmentValue( segment, -d ) ) / 2.0;
+                a1  = ( f_SegmentValue( segment, d ) - f_SegmentValue( segment, -d ) ) / ( 2.0 * d );
+            end else if( DEGREE == 2 ) begin
+                d   = 0.5 * $cos( 3.14159265358979 / 6.0 );
+                a0  = f_SegmentValue( segment, 0.0 );
+                a1  = ( f_SegmentValue( segment, d ) - f_SegmentValue( segment, -d ) ) / ( 2.0 * d );
+                a2  = ( f_SegmentValue( segment, d ) - 2.0 * a0 + f_SegmentValue( segment, -d ) ) / ( 2.0 * d * d );
+            end else begin
+                // split into the even and odd parts
+                d1  = 0.5 * $cos( 3.14159265358979 / 8.0 );
+                d2  = 0.5 * $cos( 3.0 * 3.14159265358979 / 8.0 );
+                e1  = ( f_SegmentValue( segment, d1 ) + f_SegmentValue( segment, -d1 ) ) / 2.0;
+                e2  = ( f_SegmentValue( segment, d2 ) + f_SegmentValue( segment, -d2 ) ) / 2.0;
+                o1  = ( f_SegmentValue( segment, d1 ) - f_SegmentValue( segment, -d1 ) ) / 2.0;
+                o2  = ( f_SegmentValue( segment, d2 ) - f_SegmentValue( segment, -d2 ) ) / 2.0;
+                a2  = ( e1 - e2 ) / ( d1 * d1 - d2 * d2 );
+                a0  = e1 - a2 * d1 * d1;
+                a3  = ( o1 / d1 - o2 / d2 ) / ( d1 * d1 - d2 * d2 );
+                a1  = o1 / d1 - a3 * d1 * d1;
+            end
+            case( term )
+                0:          b = a0 - a1 / 2.0 + a2 / 4.0 - a3 / 8.0;
+                1:          b = a1 - a2 + 3.0 * a3 / 4.0;
+                2:          b = a2 - 3.0 * a3 / 2.0;
+                default:    b = a3;
+            endcase
+            b = b * $pow( 2.0, COEF_FRAC );
+            f_Coefficient = b >= 0.0 ? $rtoi( b + 0.5 ) : $rtoi( b - 0.5 );
+            // round the result to nearest
+            if( term == 0 && GUARD_BITS > 0 )
+                f_Coefficient = f_Coefficient + ( 1 << ( GUARD_BITS - 1 ) );
+        end
+    endfunction
+
+    // coefficient rom, { c[DEGREE], ... c1, c0 }
+    (* syn_romstyle = "block_rom" *) reg [(DEGREE+1)*COEF_WIDTH-1:0] r_rom [0:(1<<SEGMENT_BITS)-1];
+    integer segment, term;
+    reg [(DEGREE+1)*COEF_WIDTH-1:0] r_init_row;
+    initial begin
+        for( segment = 0; segment < (1<<SEGMENT_BITS); segment = segment + 1 ) begin
+            for( term = 0; term <= DEGREE; term = term + 1 )
+                r_init_row[term*COEF_WIDTH+:COEF_WIDTH] = f_Coefficient( segment, term );
+            r_rom[segment] = r_init_row;
+        end
+    end
+    reg [(DEGREE+1)*COEF_WIDTH-1:0] r_row   = 0;
+    reg [U_BITS-1:0]                r_u     = 0;
+    always @( posedge clk ) begin
+        r_row   <= r_rom[I1[IN_WIDTH-1-:SEGMENT_BITS]];
+        r_u     <= I1[U_BITS-1:0];
+    end
+
+    // horner steps, acc[0] = c[DEGREE]
+    wire [(DEGREE+1)*COEF_WIDTH-1:0] w_acc;
+    assign w_acc[COEF_WIDTH-1:0] = r_row[DEGREE*COEF_WIDTH+:COEF_WIDTH];
+    genvar step;
+    generate
+        for( step = 1; step <= DEGREE; step = step + 1 ) begin : horner_step_loop
+            wire [U_BITS-1:0]               w_u;
+            wire [COEF_WIDTH-1:0]           w_coef;
+            wire [COEF_WIDTH+U_BITS:0]      w_product;
+            wire [COEF_WIDTH-1:0]           w_sum;
+            ff_delay #( .WIDTH( U_BITS ),     .DEPTH( (step-1)*STEP_LATENCY ) )                u_delay    ( .clk( clk ), .D( r_u ), .Q( w_u ) );
+            ff_delay #( .WIDTH( COEF_WIDTH ), .DEPTH( (step-1)*STEP_LATENCY + MULT_LATENCY ) ) coef_delay ( .clk( clk ), .D( r_row[(DEGREE-step)*COEF_WIDTH+:COEF_WIDTH] ), .Q( w_coef ) );
+            math_pipelined_multiply #( .WIDTH_A( COEF_WIDTH ), .WIDTH_B( U_BITS + 1 ), .LATENCY( MULT_LATENCY ), .SIGNED( 1 ), .DSP( DSP ) ) step_multiply
+            (
+                .clk(       clk ),
+                .I1(        w_acc[(step-1)*COEF_WIDTH+:COEF_WIDTH] ),
+                .I2(        { 1'b0, w_u } ),
+                .product(   w_product )
+            );
+            // acc * u / 2**U_BITS
+            math_pipelined_add #( .WIDTH( COEF_WIDTH ), .LATENCY( ADD_LATENCY ) ) step_add
+            (
+                .clk(   clk ),
+                .I1(    w_product[U_BITS+:COEF_WIDTH] ),
+                .I2(    w_coef ),
+                .cin(   1'b0 ),
+                .sum(   w_sum ),
+                .cout()
+            );
+            assign w_acc[step*COEF_WIDTH+:COEF_WIDTH] = w_sum;
+        end
+    endgenerate
+
+    // drop the guard bits and saturate
+    wire [COEF_WIDTH-1:0]   w_final = w_acc[DEGREE*COEF_WIDTH+:COEF_WIDTH];
+    reg  [OUT_WIDTH-1:0]    r_result = 0;
+    assign result = r_result;
+    always @( posedge clk ) begin
+        if( w_final[COEF_WIDTH-1] )
+            r_result <= 'd0;
+        else if( |w_final[COEF_WIDTH-2:COEF_FRAC+1] )
+            r_result <= { OUT_WIDTH{1'b1} };
+        else
+            r_result <= w_final[COEF_FRAC:GUARD_BITS];
+    end
+endmodule
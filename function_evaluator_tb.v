@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	function_evaluator_tb.v
+//
+// Project:	function evaluator
+//
+// Purpose:	Exhaustive test bench for function_evaluator, every input is compared
+//          against f() in real arithmetic and the maximum error is reported.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// function_evaluator_tb - feeds I1 = 0 .. 2**IN_WIDTH - 1, 1 per clock, and compares every result
+//  with f( x ) * 2**(OUT_WIDTH-1). Prints the maximum error in result ulps and the input it
+//  occurred at, FAIL when it is MAX_ERROR or more. Override the parameters to test other configurations,
+//  test_benches.sh runs every FUNCTION.
+module function_evaluator_tb
+    #(
+        parameter FUNCTION      = "EXP2",
+        parameter IN_WIDTH      = 16,
+        parameter OUT_WIDTH     = 17,
+        parameter SEGMENT_BITS  = 6,
+        parameter DEGREE        = 2,
+        parameter GUARD_BITS    = 4,
+        parameter MULT_LATENCY  = 2,
+        parameter ADD_LATENCY   = 1,
+        parameter DSP           = 1,
+        parameter MAX_ERROR     = 1.0
+    );
+    localparam LATENCY  = DEGREE * ( MULT_LATENCY + ADD_LATENCY ) + 2;
+    localparam BENCH    = "function_evaluator_tb";
+    localparam TIMEOUT  = 10 * ( ( 1 << IN_WIDTH ) + LATENCY + 100 );
+
+    function real f_FunctionValue;
+        input real x;
+        begin
+            if( FUNCTION == "EXP2" )
+                f_FunctionValue = $pow( 2.0, x );
+            else if( FUNCTION == "LOG2" )
+                f_FunctionValue = $ln( 1.0 + x ) / $ln( 2.0 );
+            else if( FUNCTION == "RECIPROCAL" )
+                f_FunctionValue = 1.0 / ( 1.0 + x );
+            else
+                f_FunctionValue = $sqrt( 1.0 + x );
+        end
+    endfunction
+
+    reg clk = 0;
+    always #5 clk = !clk;
+
+    reg  [IN_WIDTH-1:0]     r_in        = 0;
+    reg                     r_in_valid  = 0;
+    wire [OUT_WIDTH-1:0]    w_result;
+    function_evaluator
+        #(
+            .FUNCTION(      FUNCTION ),
+            .IN_WIDTH(      IN_WIDTH ),
+            .OUT_WIDTH(     OUT_WIDTH ),
+            .SEGMENT_BITS(  SEGMENT_BITS ),
+            .DEGREE(        DEGREE ),
+            .GUARD_BITS(    GUARD_BITS ),
+            .MULT_LATENCY(  MULT_LATENCY ),
+            .ADD_LATENCY(   ADD_LATENCY ),
+            .DSP(           DSP )
+        ) dut
+        (
+            .clk(       clk ),
+            .I1(        r_in ),
+            .result(    w_result )
+        );
+
+    // the input and its valid travel next to the pipeline
+    wire [IN_WIDTH-1:0] w_in;
+    wire                w_valid;
+    ff_delay #( .WIDTH( IN_WIDTH + 1 ), .DEPTH( LATENCY ) ) in_delay ( .clk( clk ), .D( { r_in_valid, r_in } ), .Q( { w_valid, w_in } ) );
+    wire w_idle = !r_in_valid && !w_valid;
+
+    `ifndef FORMAL
+        `include "./toolbox/test_bench.v"
+    `else
+        `include "test_bench.v"
+    `endif
+
+    always @( posedge clk )
+        if( w_valid )
+            check_ulps( w_in, w_result, f_FunctionValue( w_in / $pow( 2.0, IN_WIDTH ) ) * $pow( 2.0, OUT_WIDTH - 1 ) );
+
+    integer idx;
+    initial begin
+        @( posedge clk ); #1;
+        r_in_valid = 1'b1;
+        for( idx = 0; idx < ( 1 << IN_WIDTH ); idx = idx + 1 ) begin
+            r_in = idx;
+            @( posedge clk ); #1;
+        end
+        r_in_valid = 1'b0;
+        wait_idle;
+
+        if( r_checked != ( 1 << IN_WIDTH ) ) begin
+            $display( "%0d results for %0d inputs", r_checked, 1 << IN_WIDTH );
+            r_errors = r_errors + 1;
+        end
+        if( r_max_error >= MAX_ERROR )
+            r_errors = r_errors + 1;
+        $display( "%s IN_WIDTH %0d OUT_WIDTH %0d SEGMENT_BITS %0d DEGREE %0d GUARD_BITS %0d: max error %f ulps at I1 = %0d",
+            FUNCTION, IN_WIDTH, OUT_WIDTH, SEGMENT_BITS, DEGREE, GUARD_BITS, r_max_error, r_max_input );
+        test_bench_finish;
+    end
+endmodule
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	gf_multiplier.v
+//
+// Project:	galois field multiplier
+//
+// Purpose:	Pipelined GF(2^WIDTH) multiplier built from xor trees.
+//          GF(2^8) for reed-solomon, GF(2^128) for GHASH. 1 product per clock.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// gf_multiplier - product = I1 * I2 mod ( x**WIDTH + POLYNOMIAL )
+//  POLYNOMIAL      - the field polynomial without the x**WIDTH term
+//  BIT_REFLECTED   - 0: bit 0 is the x**0 coefficient. 1: bit WIDTH-1 is the x**0 coefficient (GHASH)
+//
+//  reed-solomon    WIDTH 8,    POLYNOMIAL 'h1D,    BIT_REFLECTED 0
+//  aes             WIDTH 8,    POLYNOMIAL 'h1B,    BIT_REFLECTED 0
+//  GHASH           WIDTH 128,  POLYNOMIAL 'h87,    BIT_REFLECTED 1
+//
+// The multiply is split into 2 sets of 'math_pipelined_reduce' xor trees
+//  carry-less product  c[n] = ^( I1[i] & I2[n-i] )             2*WIDTH-1 trees, PRODUCT_LATENCY
+//  reduction           product[k] = ^( c[n] & (x**n mod P)[k] ) WIDTH trees,     REDUCE_LATENCY
+// The reduction matrix, x**n mod P, is computed at elaboration time so only the terms that are
+// set are wired into the trees. The product is valid exactly 'LATENCY' clocks after the inputs.
+module gf_multiplier
+    #(
+        parameter WIDTH         = 8,
+        parameter POLYNOMIAL    = 'h1D,
+        parameter LATENCY       = 2,
+        parameter BIT_REFLECTED = 0
+    )
+    (
+        input   wire                clk,
+        input   wire    [WIDTH-1:0] I1,
+        input   wire    [WIDTH-1:0] I2,
+        output  wire    [WIDTH-1:0] product
+    );
+    localparam [WIDTH-1:0]  POLYNOMIAL_VALUE    = POLYNOMIAL;
+    localparam              PRODUCT_LATENCY     = (LATENCY + 1) / 2;
+    localparam              REDUCE_LATENCY      = LATENCY - PRODUCT_LATENCY;
+    localparam              PRODUCT_WIDTH       = 2 * WIDTH - 1;
+
+    // f_GfPowerMod - Returns x**power mod P
+    function automatic [WIDTH-1:0] f_GfPowerMod;
+        input integer power;
+        reg [WIDTH:0] remainder;
+        integer idx;
+        begin
+            remainder = 1;
+            for( idx = 0; idx < power; idx = idx + 1 ) begin
+                remainder = { remainder[WIDTH-1:0], 1'b0 };
+                if( remainder[WIDTH] )
+                    remainder = remainder ^ { 1'b1, POLYNOMIAL_VALUE };
+            end
+            f_GfPowerMod = remainder[WIDTH-1:0];
+        end
+    endfunction
+
+    genvar idx;
+    genvar term;
+    genvar power;
+
+    // put the inputs and output in x**0 at bit 0 order
+    wire [WIDTH-1:0] w_I1;
+    wire [WIDTH-1:0] w_I2;
+    wire [WIDTH-1:0] w_product;
+    generate
+        for( idx = 0; idx < WIDTH; idx = idx + 1 ) begin : gf_reflect_loop
+            if( BIT_REFLECTED ) begin
+                assign w_I1[idx]            = I1[WIDTH-1-idx];
+                assign w_I2[idx]            = I2[WIDTH-1-idx];
+                assign product[WIDTH-1-idx] = w_product[idx];
+            end else begin
+                assign w_I1[idx]            = I1[idx];
+                assign w_I2[idx]            = I2[idx];
+                assign product[idx]         = w_product[idx];
+            end
+        end
+    endgenerate
+
+    // carry-less product
+    wire [PRODUCT_WIDTH-1:0] w_clmul;
+    generate
+        for( power = 0; power < PRODUCT_WIDTH; power = power + 1 ) begin : gf_clmul_loop
+            wire [WIDTH-1:0] w_terms;
+            for( term = 0; term < WIDTH; term = term + 1 ) begin : gf_clmul_term_loop
+                if( power - term >= 0 && power - term < WIDTH )
+                    assign w_terms[term] = w_I1[term] & w_I2[power-term];
+                else
+                    assign w_terms[term] = 1'b0;
+            end
+            math_pipelined_reduce #( .WIDTH( WIDTH ), .LATENCY( PRODUCT_LATENCY ), .OPERATION( "XOR" ) ) clmul_tree
+            (
+                .clk(       clk ),
+                .I1(        w_terms ),
+                .result(    w_clmul[power] )
+            );
+        end
+    endgenerate
+
+    // reduction, row 'power' of the matrix is x**power mod P
+    wire [PRODUCT_WIDTH*WIDTH-1:0] w_matrix;
+    generate
+        for( power = 0; power < PRODUCT_WIDTH; power = power + 1 ) begin : gf_matrix_loop
+            localparam [WIDTH-1:0] ROW = f_GfPowerMod( power );
+            assign w_matrix[power*WIDTH+:WIDTH] = ROW & { WIDTH{ w_clmul[power] } };
+        end
+        for( idx = 0; idx < WIDTH; idx = idx + 1 ) begin : gf_reduce_loop
+            wire [PRODUCT_WIDTH-1:0] w_terms;
+            for( power = 0; power < PRODUCT_WIDTH; power = power + 1 ) begin : gf_reduce_term_loop
+                assign w_terms[power] = w_matrix[power*WIDTH+idx];
+            end
+            math_pipelined_reduce #( .WIDTH( PRODUCT_WIDTH ), .LATENCY( REDUCE_LATENCY ), .OPERATION( "XOR" ) ) reduce_tree
+            (
+                .clk(       clk ),
+                .I1(        w_terms ),
+                .result(    w_product[idx] )
+            );
+        end
+    endgenerate
+endmodule
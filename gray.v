@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	gray.v
+//
+// Project:	gray code converters
+//
+// Purpose:	Pipelined binary to gray, and gray to binary converters with a
+//          configurable latency. Both sustain 1 conversion per clock.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// binary_to_gray - gray = I1 ^ (I1 >> 1)
+// Only a single 2 input xor deep, the conversion is done in the first stage and
+// the remaining 'LATENCY' - 1 stages are a delay line. LATENCY = 0 is combinational
+module binary_to_gray
+    #(
+        parameter WIDTH     = 4,
+        parameter LATENCY   = 1
+    )
+    (
+        input   wire                clk,
+        input   wire    [WIDTH-1:0] I1,
+        output  wire    [WIDTH-1:0] gray
+    );
+    wire [WIDTH-1:0] w_gray = I1 ^ (I1 >> 1);
+    generate
+        if( LATENCY == 0 ) begin
+            assign gray = w_gray;
+        end else begin
+            reg [WIDTH-1:0] r_gray = 0;
+            always @( posedge clk ) r_gray <= w_gray;
+            ff_delay #( .WIDTH( WIDTH ), .DEPTH( LATENCY - 1 ) ) gray_delay ( .clk( clk ), .D( r_gray ), .Q( gray ) );
+        end
+    endgenerate
+endmodule
+
+// gray_to_binary - binary[n] = ^gray[WIDTH-1:n]
+// The suffix xor is built as a radix 'RADIX' prefix tree. Each level of the tree
+// xors 'RADIX' values spaced RADIX**level bits apart, so after level 'l' each bit
+// holds the xor of the next RADIX**(l+1) gray bits. The radix is chosen with the
+// N-ary tree functions so the depth fits inside 'LATENCY'. Any unused latency is
+// added as a delay line so the output is always valid exactly 'LATENCY' clocks
+// after the input. LATENCY = 0 is combinational
+//  RADIX 2, WIDTH 8. 'h:l' is the xor of gray bits h down to l
+//  level 0:    7   6   5   4   3   2   1   0
+//  level 1:    7  7:6 6:5 5:4 4:3 3:2 2:1 1:0      stride 1
+//  level 2:    7  7:6 7:5 7:4 6:3 5:2 4:1 3:0      stride 2
+//  level 3:    7  7:6 7:5 7:4 7:3 7:2 7:1 7:0      stride 4
+module gray_to_binary
+    #(
+        parameter WIDTH     = 4,
+        parameter LATENCY   = 2
+    )
+    (
+        input   wire                clk,
+        input   wire    [WIDTH-1:0] I1,
+        output  wire    [WIDTH-1:0] binary
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    genvar level;
+    genvar idx;
+    genvar input_index;
+    generate
+        if( LATENCY == 0 ) begin
+            for( idx = 0; idx < WIDTH; idx = idx + 1 ) begin : gray_base_loop
+                assign binary[idx] = ^I1[WIDTH-1:idx];
+            end
+        end else begin
+            localparam RADIX    = f_NaryRecursionGetUnitWidthForLatency( WIDTH, LATENCY );  // smallest xor width that meets 'LATENCY'
+            localparam LEVELS   = f_NaryRecursionGetDepth( WIDTH, RADIX );                  // actual depth of the tree
+            // level 0 is the input, level 'LEVELS' is the result
+            wire [WIDTH*(LEVELS+1)-1:0] w_prefix;
+            assign w_prefix[WIDTH-1:0] = I1;
+            for( level = 0; level < LEVELS; level = level + 1 ) begin : gray_level_loop
+                for( idx = 0; idx < WIDTH; idx = idx + 1 ) begin : gray_bit_loop
+                    // make the input wires for this unit
+                    wire [RADIX-1:0] unit_inputs;
+                    // inputs past the msb are 0, they will be optimized away
+                    for( input_index = 0; input_index < RADIX; input_index = input_index + 1 ) begin : gray_input_loop
+                        if( idx + input_index * RADIX**level < WIDTH )
+                            assign unit_inputs[input_index] = w_prefix[level*WIDTH + idx + input_index * RADIX**level];
+                        else
+                            assign unit_inputs[input_index] = 1'b0;
+                    end
+                    // perform the function and store the output
+                    reg r_prefix = 0;
+                    always @( posedge clk ) r_prefix <= ^unit_inputs;
+                    assign w_prefix[(level+1)*WIDTH+idx] = r_prefix;
+                end
+            end
+            ff_delay #( .WIDTH( WIDTH ), .DEPTH( LATENCY - LEVELS ) ) binary_delay ( .clk( clk ), .D( w_prefix[WIDTH*LEVELS+:WIDTH] ), .Q( binary ) );
+        end
+    endgenerate
+endmodule
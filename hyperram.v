@@ -0,0 +1,435 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	hyperram.v
+//
+// Project:	hyperram
+//
+// Purpose:	HyperBus PSRAM controller with a command queue and linear bursts,
+//          and a cycle model of the memory for simulation.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// The hb_* ports carry both edges of a HyperBus clock per 'clk', 1 16 bit word per clock, they are
+// meant for a pair of ODDR / IDDR per pin and a 90 degree shifted CK, 'hyperram_io' in ddr_io.v. The
+// first byte, the rising edge, is [15:8] of hb_dq_* and [1] of hb_rwds_*, the second byte is [7:0] and [0].
+//
+// A transaction, counted in clocks from the first clock hb_cs_n is low:
+//  0 .. 2                  the 48 bit command / address, CA[47:32], CA[31:16], CA[15:0]
+//                          the memory sets rwds during the command when it needs the longer latency
+//  3 .. 3 + L - 1          latency, L = LATENCY or 2 * LATENCY, 0 for a register write
+//  3 + L ..                data, 1 word per clock, linear burst
+// A write drives rwds as the byte mask, high = byte not written. A read word is taken on a clock
+// its rwds pair is 2'b10, so a memory that pauses a read at a row boundary is followed.
+
+// hyperram_controller - queued linear burst reads and writes of 16 bit words
+//  cmd_*       a burst of cmd_length + 1 words at word address cmd_address, taken into a command queue
+//              of 2 ** QUEUE_ADDRESS_WIDTH entries. cmd_register addresses the register space, a register
+//              write is 1 word with no latency.
+//  wr_*        the write words with byte enables, wr_strobe[1] for [15:8], through a write queue of
+//              2 ** WRITE_ADDRESS_WIDTH words. A write burst starts once all its words are queued.
+//  rd_*        the read words in order, 1 clock after they arrive, there is no back pressure.
+//  Commands are issued in order. A command that continues the burst in flight, same direction,
+//  memory space and the next word address, is appended to it without a new command and latency,
+//  while the burst stays within MAX_BURST words, so a stream of short sequential commands runs as
+//  long bursts at 1 word per clock. MAX_BURST keeps hb_cs_n low for less than the tCSM the memory
+//  needs for its refresh.
+//  FIXED_LATENCY 1 always waits 2 * LATENCY, the memory's power on setting, 0 follows rwds, taken
+//  on clock 2 of the command, so it needs hb_rwds_in without io delay. 'hyperram_io' needs 1.
+//  No command is issued for INIT_CLOCKS after rst, the memory's power on time.
+//  LENGTH_WIDTH <= WRITE_ADDRESS_WIDTH, LATENCY >= 1
+module hyperram_controller
+    #(
+        parameter ADDRESS_WIDTH         = 22,
+        parameter LENGTH_WIDTH          = 7,
+        parameter MAX_BURST             = 128,
+        parameter LATENCY               = 6,
+        parameter FIXED_LATENCY         = 1,
+        parameter QUEUE_ADDRESS_WIDTH   = 2,
+        parameter WRITE_ADDRESS_WIDTH   = 8,
+        parameter INIT_CLOCKS           = 15000
+    )
+    (
+        input   wire                        clk,
+        input   wire                        rst,
+        // commands
+        input   wire                        cmd_valid,
+        output  wire                        cmd_ready,
+        input   wire                        cmd_write,
+        input   wire                        cmd_register,
+        input   wire    [ADDRESS_WIDTH-1:0] cmd_address,
+        input   wire    [LENGTH_WIDTH-1:0]  cmd_length,
+        input   wire                        wr_valid,
+        output  wire                        wr_ready,
+        input   wire    [15:0]              wr_data,
+        input   wire    [1:0]               wr_strobe,
+        output  wire                        rd_valid,
+        output  wire    [15:0]              rd_data,
+        // HyperBus, both edges per clock
+        output  wire                        hb_reset_n,
+        output  wire                        hb_cs_n,
+        output  wire                        hb_ck_enable,
+        output  wire    [15:0]              hb_dq_out,
+        output  wire                        hb_dq_oe,
+        input   wire    [15:0]              hb_dq_in,
+        output  wire    [1:0]               hb_rwds_out,
+        output  wire                        hb_rwds_oe,
+        input   wire    [1:0]               hb_rwds_in
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    localparam BURST_WIDTH  = f_Log2( MAX_BURST + 1 ) + 1;
+    localparam INIT_WIDTH   = f_Log2( INIT_CLOCKS + 1 );
+    localparam CMD_WIDTH    = 2 + ADDRESS_WIDTH + LENGTH_WIDTH;
+
+    localparam STATE_INIT       = 0;
+    localparam STATE_IDLE       = 1;
+    localparam STATE_COMMAND    = 2;
+    localparam STATE_LATENCY    = 3;
+    localparam STATE_WRITE      = 4;
+    localparam STATE_READ       = 5;
+
+    // command queue
+    wire                        w_cmd_valid;
+    reg                         w_cmd_pop;
+    wire                        w_cmd_write;
+    wire                        w_cmd_register;
+    wire [ADDRESS_WIDTH-1:0]    w_cmd_address;
+    wire [LENGTH_WIDTH-1:0]     w_cmd_length;
+    fifo_sync #( .WIDTH( CMD_WIDTH ), .ADDRESS_WIDTH( QUEUE_ADDRESS_WIDTH ) ) command_queue
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  cmd_valid ),
+        .in_ready(  cmd_ready ),
+        .in_data(   { cmd_write, cmd_register, cmd_address, cmd_length } ),
+        .out_valid( w_cmd_valid ),
+        .out_ready( w_cmd_pop ),
+        .out_data(  { w_cmd_write, w_cmd_register, w_cmd_address, w_cmd_length } ),
+        .count()
+    );
+
+    // write queue
+    reg                             w_wr_pop;
+    wire [15:0]                     w_wr_data;
+    wire [1:0]                      w_wr_strobe;
+    wire [WRITE_ADDRESS_WIDTH:0]    w_wr_count;
+    fifo_sync #( .WIDTH( 18 ), .ADDRESS_WIDTH( WRITE_ADDRESS_WIDTH ) ) write_queue
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  wr_valid ),
+        .in_ready(  wr_ready ),
+        .in_data(   { wr_strobe, wr_data } ),
+        .out_valid(),
+        .out_ready( w_wr_pop ),
+        .out_data(  { w_wr_strobe, w_wr_data } ),
+        .count(     w_wr_count )
+    );
+
+    reg  [2:0]                  r_state     = STATE_INIT;
+    reg  [INIT_WIDTH-1:0]       r_init      = 0;
+    reg  [7:0]                  r_count     = 0;
+    reg  [47:0]                 r_ca        = 0;
+    reg                         r_write     = 0;
+    reg                         r_register  = 0;
+    reg  [ADDRESS_WIDTH-1:0]    r_address   = 0;    // write: the next word to send, read: the next word to take
+    reg  [LENGTH_WIDTH:0]       r_remaining = 0;    // write: words still to send, read: words still to take
+    reg  [BURST_WIDTH-1:0]      r_burst     = 0;    // words in the burst so far
+
+    // the command / address of the queue head, linear burst
+    wire [31:0] w_word_address = w_cmd_address;
+    wire [47:0] w_ca = { ~w_cmd_write, w_cmd_register, 1'b1, w_word_address[31:3], 13'd0, w_word_address[2:0] };
+
+    // the queue head can start a burst, writes once all their words are queued
+    wire w_start    = w_cmd_valid && ( !w_cmd_write || w_wr_count > w_cmd_length );
+    // the queue head continues the burst in flight, a read checks on the clock its last word arrives
+    wire [ADDRESS_WIDTH-1:0]    w_next_address  = r_state == STATE_READ ? r_address + 1'b1 : r_address;
+    wire [BURST_WIDTH-1:0]      w_next_burst    = r_state == STATE_READ ? r_burst + 1'b1 : r_burst;
+    wire w_append   = w_cmd_valid && w_cmd_write == r_write && !w_cmd_register && !r_register
+                    && w_cmd_address == w_next_address && w_next_burst + w_cmd_length + 1'b1 <= MAX_BURST
+                    && ( !w_cmd_write || w_wr_count > w_cmd_length );
+    wire w_strobe   = hb_rwds_in == 2'b10;
+
+    reg         r_reset_n   = 0;
+    reg         r_cs_n      = 1;
+    reg         r_ck_enable = 0;
+    reg [15:0]  r_dq_out    = 0;
+    reg         r_dq_oe     = 0;
+    reg [1:0]   r_rwds_out  = 0;
+    reg         r_rwds_oe   = 0;
+    reg         r_rd_valid  = 0;
+    reg [15:0]  r_rd_data   = 0;
+    assign hb_reset_n   = r_reset_n;
+    assign hb_cs_n      = r_cs_n;
+    assign hb_ck_enable = r_ck_enable;
+    assign hb_dq_out    = r_dq_out;
+    assign hb_dq_oe     = r_dq_oe;
+    assign hb_rwds_out  = r_rwds_out;
+    assign hb_rwds_oe   = r_rwds_oe;
+    assign rd_valid     = r_rd_valid;
+    assign rd_data      = r_rd_data;
+
+    // pops of the queues, the write word is loaded into r_dq_out on the clock it is popped
+    always @(*) begin
+        w_cmd_pop   = 1'b0;
+        w_wr_pop    = 1'b0;
+        case( r_state )
+            STATE_IDLE:     w_cmd_pop   = w_start;
+            STATE_COMMAND:  w_wr_pop    = r_count == 2 && r_write && r_register;
+            STATE_LATENCY:  w_wr_pop    = r_count == 1 && r_write;
+            STATE_WRITE: begin
+                w_cmd_pop   = r_remaining == 0 && w_append;
+                w_wr_pop    = r_remaining != 0 || w_append;
+            end
+            STATE_READ:     w_cmd_pop   = w_strobe && r_remaining == 1 && w_append;
+            default: ;
+        endcase
+    end
+
+    always @( posedge clk ) begin
+        r_reset_n   <= !rst;
+        r_rd_valid  <= 1'b0;
+        if( w_wr_pop ) begin
+            r_dq_out    <= w_wr_data;
+            r_dq_oe     <= 1'b1;
+            r_rwds_out  <= ~w_wr_strobe;
+            r_rwds_oe   <= 1'b1;
+            r_address   <= r_address + 1'b1;
+            r_burst     <= r_burst + 1'b1;
+        end
+        case( r_state )
+            STATE_INIT: begin
+                r_init <= r_init + 1'b1;
+                if( r_init == INIT_CLOCKS )
+                    r_state <= STATE_IDLE;
+            end
+            STATE_IDLE: begin
+                if( w_start ) begin
+                    r_cs_n      <= 1'b0;
+                    r_ck_enable <= 1'b1;
+                    r_dq_out    <= w_ca[47:32];
+                    r_dq_oe     <= 1'b1;
+                    r_ca        <= w_ca;
+                    r_write     <= w_cmd_write;
+                    r_register  <= w_cmd_register;
+                    r_address   <= w_cmd_address;
+                    r_remaining <= w_cmd_length + 1'b1;
+                    r_burst     <= 'd0;
+                    r_count     <= 'd0;
+                    r_state     <= STATE_COMMAND;
+                end
+            end
+            STATE_COMMAND: begin
+                r_count <= r_count + 1'b1;
+                if( r_count == 0 )
+                    r_dq_out <= r_ca[31:16];
+                if( r_count == 1 )
+                    r_dq_out <= r_ca[15:0];
+                if( r_count == 2 ) begin
+                    if( r_write && r_register ) begin
+                        // no latency, the word was loaded by the pop
+                        r_remaining <= r_remaining - 1'b1;
+                        r_state     <= STATE_WRITE;
+                    end else begin
+                        r_dq_oe     <= 1'b0;
+                        if( r_write ) begin
+                            r_count <= FIXED_LATENCY || hb_rwds_in[1] ? 2 * LATENCY : LATENCY;
+                            r_state <= STATE_LATENCY;
+                        end else begin
+                            // reads follow rwds, the latency is not counted
+                            r_state <= STATE_READ;
+                        end
+                    end
+                end
+            end
+            STATE_LATENCY: begin
+                r_count <= r_count - 1'b1;
+                if( r_count == 1 ) begin
+                    r_remaining <= r_remaining - 1'b1;
+                    r_state     <= STATE_WRITE;
+                end
+            end
+            STATE_WRITE: begin
+                if( r_remaining != 0 ) begin
+                    r_remaining <= r_remaining - 1'b1;
+                end else if( w_append ) begin
+                    r_remaining <= w_cmd_length;
+                end else begin
+                    r_cs_n      <= 1'b1;
+                    r_ck_enable <= 1'b0;
+                    r_dq_oe     <= 1'b0;
+                    r_rwds_oe   <= 1'b0;
+                    r_state     <= STATE_IDLE;
+                end
+            end
+            STATE_READ: begin
+                if( w_strobe ) begin
+                    r_rd_valid  <= 1'b1;
+                    r_rd_data   <= hb_dq_in;
+                    r_address   <= r_address + 1'b1;
+                    r_burst     <= r_burst + 1'b1;
+                    if( r_remaining != 1 ) begin
+                        r_remaining <= r_remaining - 1'b1;
+                    end else if( w_append ) begin
+                        r_remaining <= w_cmd_length + 1'b1;
+                    end else begin
+                        r_cs_n      <= 1'b1;
+                        r_ck_enable <= 1'b0;
+                        r_state     <= STATE_IDLE;
+                    end
+                end
+            end
+            default: r_state <= STATE_IDLE;
+        endcase
+        if( rst ) begin
+            r_state     <= STATE_INIT;
+            r_init      <= 'd0;
+            r_cs_n      <= 1'b1;
+            r_ck_enable <= 1'b0;
+            r_dq_oe     <= 1'b0;
+            r_rwds_oe   <= 1'b0;
+        end
+    end
+endmodule
+
+// hyperram_simulation_model - cycle model of a HyperRAM on the hb_* ports of 'hyperram_controller'
+//  The memory holds 2 ** ADDRESS_WIDTH words, higher address bits wrap. It has a single register,
+//  any register write sets it and any register read returns it.
+//  FIXED_LATENCY 0 asks for the longer latency every REFRESH_EVERY transactions, 0 never.
+//  A read that crosses into a new row of ROW_WORDS words holds rwds low for ROW_PAUSE clocks before
+//  the first word of the row, like a memory that opens the next row, ROW_WORDS 0 never pauses.
+//  Connect dq_in / rwds_in to the controller's hb_dq_out / hb_rwds_out and dq_out / rwds_out to its
+//  hb_dq_in / hb_rwds_in.
+module hyperram_simulation_model
+    #(
+        parameter ADDRESS_WIDTH = 16,
+        parameter LATENCY       = 6,
+        parameter FIXED_LATENCY = 1,
+        parameter REFRESH_EVERY = 0,
+        parameter ROW_WORDS     = 0,
+        parameter ROW_PAUSE     = 2
+    )
+    (
+        input   wire            clk,
+        input   wire            reset_n,
+        input   wire            cs_n,
+        input   wire            ck_enable,
+        input   wire    [15:0]  dq_in,
+        output  wire    [15:0]  dq_out,
+        input   wire    [1:0]   rwds_in,
+        output  wire    [1:0]   rwds_out
+    );
+    localparam DEPTH = 1 << ADDRESS_WIDTH;
+
+    reg [15:0]  r_memory [0:DEPTH-1];
+    integer idx;
+    initial for( idx = 0; idx < DEPTH; idx = idx + 1 ) r_memory[idx] = 16'd0;
+
+    reg [15:0]              r_register      = 16'h8f1f;
+    reg [1:0]               r_phase         = 0;    // 0: command, 1: latency, 2: data
+    reg [1:0]               r_count         = 0;
+    reg [7:0]               r_wait          = 0;
+    reg [31:0]              r_ca_high       = 0;
+    reg [ADDRESS_WIDTH-1:0] r_address       = 0;
+    reg                     r_double        = 0;
+    reg [15:0]              r_transactions  = 0;
+    reg [7:0]               r_pause         = 0;    // clocks paused before the current word
+    reg [15:0]              r_dq_out        = 0;
+    reg [1:0]               r_rwds_out      = 0;
+    assign dq_out   = r_dq_out;
+    assign rwds_out = r_rwds_out;
+
+    // the command / address as it completes
+    wire [47:0]     w_ca        = { r_ca_high, dq_in };
+    wire            w_read      = r_ca_high[31];
+    wire            w_register  = r_ca_high[30];
+    wire [31:0]     w_address   = { w_ca[44:16], w_ca[2:0] };
+    wire [7:0]      w_latency   = !w_read && w_register ? 8'd0 : r_double ? 2 * LATENCY : LATENCY;
+
+    always @( posedge clk ) begin
+        if( !reset_n || cs_n ) begin
+            r_phase     <= 'd0;
+            r_count     <= 'd0;
+            r_pause     <= 'd0;
+            r_rwds_out  <= 2'b00;
+        end else if( ck_enable ) begin
+            case( r_phase )
+                0: begin
+                    r_count <= r_count + 1'b1;
+                    if( r_count == 0 ) begin
+                        r_ca_high[31:16]    <= dq_in;
+                        r_double            <= FIXED_LATENCY || ( REFRESH_EVERY != 0 && r_transactions == REFRESH_EVERY - 1 );
+                        r_rwds_out          <= { 2{ FIXED_LATENCY || ( REFRESH_EVERY != 0 && r_transactions == REFRESH_EVERY - 1 ) } };
+                        r_transactions      <= REFRESH_EVERY != 0 && r_transactions == REFRESH_EVERY - 1 ? 16'd0 : r_transactions + 1'b1;
+                    end
+                    if( r_count == 1 )
+                        r_ca_high[15:0]     <= dq_in;
+                    if( r_count == 2 ) begin
+                        r_rwds_out  <= 2'b00;
+                        r_address   <= w_address;
+                        r_wait      <= w_latency;
+                        r_phase     <= w_latency == 0 ? 2'd2 : 2'd1;
+                    end
+                end
+                1: begin
+                    r_wait <= r_wait - 1'b1;
+                    if( r_wait == 1 ) begin
+                        r_phase <= 2'd2;
+                        if( w_read ) begin
+                            r_dq_out    <= w_register ? r_register : r_memory[r_address];
+                            r_rwds_out  <= 2'b10;
+                            r_address   <= r_address + 1'b1;
+                        end
+                    end
+                end
+                default: begin
+                    if( w_read ) begin
+                        if( ROW_WORDS != 0 && !w_register && r_address % ROW_WORDS == 0 && r_pause != ROW_PAUSE ) begin
+                            // the first word of a new row, rwds stops toggling
+                            r_rwds_out  <= 2'b00;
+                            r_pause     <= r_pause + 1'b1;
+                        end else begin
+                            r_dq_out    <= w_register ? r_register : r_memory[r_address];
+                            r_rwds_out  <= 2'b10;
+                            r_address   <= r_address + 1'b1;
+                            r_pause     <= 'd0;
+                        end
+                    end else begin
+                        if( w_register ) begin
+                            r_register <= dq_in;
+                        end else begin
+                            if( !rwds_in[1] )
+                                r_memory[r_address][15:8]   <= dq_in[15:8];
+                            if( !rwds_in[0] )
+                                r_memory[r_address][7:0]    <= dq_in[7:0];
+                        end
+                        r_address <= r_address + 1'b1;
+                    end
+                end
+            endcase
+        end
+    end
+endmodule
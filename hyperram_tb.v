@@ -0,0 +1,288 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	hyperram_tb.v
+//
+// Project:	hyperram
+//
+// Purpose:	Test bench for hyperram_controller against hyperram_simulation_model.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// hyperram_tb - hyperram_controller on a hyperram_simulation_model that doubles the latency every
+//  REFRESH_EVERY transactions and pauses reads at every row of ROW_WORDS words.
+//  1   sequential 4 word writes, appended into MAX_BURST word bursts
+//  2   separate writes with byte masks and a write across rows
+//  3   the same words read back, appended into MAX_BURST word bursts that pause at every row
+//  Every read word is compared with a reference memory, then the model's memory is compared with it
+//  word by word, which catches writes off by a latency clock. The bench also checks that:
+//  - bursts reached MAX_BURST and never passed it;
+//  - the memory asked for the doubled latency on a write;
+//  - reads paused at a row.
+module hyperram_tb
+    #(
+        parameter ADDRESS_WIDTH = 10,
+        parameter LATENCY       = 3,
+        parameter MAX_BURST     = 16,
+        parameter REFRESH_EVERY = 3,
+        parameter ROW_WORDS     = 8,
+        parameter ROW_PAUSE     = 2
+    );
+    localparam DEPTH    = 1 << ADDRESS_WIDTH;
+    localparam BENCH    = "hyperram_tb";
+    localparam TIMEOUT  = 2000000;
+
+    reg clk = 0;
+    always #5 clk = !clk;
+    reg rst = 1;
+
+    reg                         cmd_valid       = 0;
+    wire                        cmd_ready;
+    reg                         cmd_write       = 0;
+    reg  [ADDRESS_WIDTH-1:0]    cmd_address     = 0;
+    reg  [6:0]                  cmd_length      = 0;
+    reg                         wr_valid        = 0;
+    wire                        wr_ready;
+    reg  [15:0]                 wr_data         = 0;
+    reg  [1:0]                  wr_strobe       = 0;
+    wire                        rd_valid;
+    wire [15:0]                 rd_data;
+    wire                        hb_reset_n;
+    wire                        hb_cs_n;
+    wire                        hb_ck_enable;
+    wire [15:0]                 hb_dq_out;
+    wire                        hb_dq_oe;
+    wire [15:0]                 hb_dq_in;
+    wire [1:0]                  hb_rwds_out;
+    wire                        hb_rwds_oe;
+    wire [1:0]                  hb_rwds_in;
+
+    hyperram_controller
+        #(
+            .ADDRESS_WIDTH( ADDRESS_WIDTH ),
+            .LENGTH_WIDTH(  7 ),
+            .MAX_BURST(     MAX_BURST ),
+            .LATENCY(       LATENCY ),
+            .FIXED_LATENCY( 0 ),
+            .INIT_CLOCKS(   10 )
+        ) dut
+        (
+            .clk(           clk ),
+            .rst(           rst ),
+            .cmd_valid(     cmd_valid ),
+            .cmd_ready(     cmd_ready ),
+            .cmd_write(     cmd_write ),
+            .cmd_register(  1'b0 ),
+            .cmd_address(   cmd_address ),
+            .cmd_length(    cmd_length ),
+            .wr_valid(      wr_valid ),
+            .wr_ready(      wr_ready ),
+            .wr_data(       wr_data ),
+            .wr_strobe(     wr_strobe ),
+            .rd_valid(      rd_valid ),
+            .rd_data(       rd_data ),
+            .hb_reset_n(    hb_reset_n ),
+            .hb_cs_n(       hb_cs_n ),
+            .hb_ck_enable(  hb_ck_enable ),
+            .hb_dq_out(     hb_dq_out ),
+            .hb_dq_oe(      hb_dq_oe ),
+            .hb_dq_in(      hb_dq_in ),
+            .hb_rwds_out(   hb_rwds_out ),
+            .hb_rwds_oe(    hb_rwds_oe ),
+            .hb_rwds_in(    hb_rwds_in )
+        );
+
+    hyperram_simulation_model
+        #(
+            .ADDRESS_WIDTH( ADDRESS_WIDTH ),
+            .LATENCY(       LATENCY ),
+            .FIXED_LATENCY( 0 ),
+            .REFRESH_EVERY( REFRESH_EVERY ),
+            .ROW_WORDS(     ROW_WORDS ),
+            .ROW_PAUSE(     ROW_PAUSE )
+        ) model
+        (
+            .clk(       clk ),
+            .reset_n(   hb_reset_n ),
+            .cs_n(      hb_cs_n ),
+            .ck_enable( hb_ck_enable ),
+            .dq_in(     hb_dq_out ),
+            .dq_out(    hb_dq_in ),
+            .rwds_in(   hb_rwds_out ),
+            .rwds_out(  hb_rwds_in )
+        );
+
+    // reference memory and the addresses of the reads in flight
+    reg [15:0]              r_reference [0:DEPTH-1];
+    reg [ADDRESS_WIDTH-1:0] r_expect    [0:255];
+    integer                 r_expect_write  = 0;
+    integer                 r_expect_read   = 0;
+    integer                 idx;
+    initial for( idx = 0; idx < DEPTH; idx = idx + 1 ) r_reference[idx] = 16'd0;
+    wire w_idle = hb_cs_n && !dut.w_cmd_valid && r_expect_read == r_expect_write;
+
+    `ifndef FORMAL
+        `include "./toolbox/test_bench.v"
+    `else
+        `include "test_bench.v"
+    `endif
+
+    task write_word;
+        input [ADDRESS_WIDTH-1:0]   address;
+        input [15:0]                data;
+        input [1:0]                 strobe;
+        begin
+            wr_valid    = 1'b1;
+            wr_data     = data;
+            wr_strobe   = strobe;
+            while( !wr_ready ) begin @( posedge clk ); #1; end
+            @( posedge clk ); #1;
+            wr_valid    = 1'b0;
+            if( strobe[1] ) r_reference[address][15:8]  = data[15:8];
+            if( strobe[0] ) r_reference[address][7:0]   = data[7:0];
+        end
+    endtask
+
+    task command;
+        input                       write;
+        input [ADDRESS_WIDTH-1:0]   address;
+        input integer               words;
+        integer                     word;
+        begin
+            cmd_valid   = 1'b1;
+            cmd_write   = write;
+            cmd_address = address;
+            cmd_length  = words - 1;
+            while( !cmd_ready ) begin @( posedge clk ); #1; end
+            @( posedge clk ); #1;
+            cmd_valid   = 1'b0;
+            if( !write ) begin
+                for( word = 0; word < words; word = word + 1 ) begin
+                    r_expect[r_expect_write%256]    = address + word;
+                    r_expect_write                  = r_expect_write + 1;
+                end
+            end
+        end
+    endtask
+
+    // queues the words first, a write burst only starts once all its words are queued
+    task write_burst;
+        input [ADDRESS_WIDTH-1:0]   address;
+        input integer               words;
+        input integer               pass;
+        input [1:0]                 strobe;
+        integer                     word;
+        begin
+            for( word = 0; word < words; word = word + 1 )
+                write_word( address + word, f_Data( address + word, pass ), strobe );
+            command( 1'b1, address, words );
+        end
+    endtask
+
+    // read words in order
+    always @( posedge clk ) begin
+        if( rd_valid ) begin
+            if( r_expect_read == r_expect_write ) begin
+                $display( "unexpected read word %h", rd_data );
+                r_errors = r_errors + 1;
+            end else begin
+                if( rd_data !== r_reference[r_expect[r_expect_read%256]] ) begin
+                    $display( "read %h at %h, expected %h", rd_data, r_expect[r_expect_read%256], r_reference[r_expect[r_expect_read%256]] );
+                    r_errors = r_errors + 1;
+                end
+                r_expect_read = r_expect_read + 1;
+            end
+        end
+    end
+
+    // memory side monitors, words per chip select, doubled write latencies and row pauses
+    integer r_words         = 0;
+    integer r_max_words     = 0;
+    integer r_doubled       = 0;
+    integer r_pauses        = 0;
+    always @( posedge clk ) begin
+        if( hb_cs_n ) begin
+            if( r_words > r_max_words )
+                r_max_words = r_words;
+            r_words = 0;
+        end else if( hb_ck_enable ) begin
+            if( model.r_phase == 2 && !model.w_read && !model.w_register )
+                r_words = r_words + 1;
+            if( model.r_phase == 2 && model.w_read && model.r_rwds_out == 2'b10 )
+                r_words = r_words + 1;
+            if( model.r_phase == 2 && model.w_read && model.r_pause != 0 && model.r_rwds_out == 2'b00 )
+                r_pauses = r_pauses + 1;
+            if( model.r_phase == 0 && model.r_count == 2 && model.r_double && !model.w_read )
+                r_doubled = r_doubled + 1;
+        end
+    end
+
+    initial begin
+        repeat( 4 ) @( posedge clk );
+        #1 rst = 1'b0;
+
+        // 1: 64 words in 4 word commands, appended into MAX_BURST word bursts. All the words are queued
+        //    first so the commands are always there when a burst could be appended.
+        for( idx = 0; idx < 64; idx = idx + 1 )
+            write_word( 'h10 + idx, f_Data( 'h10 + idx, 1 ), 2'b11 );
+        for( idx = 0; idx < 16; idx = idx + 1 )
+            command( 1'b1, 'h10 + idx * 4, 4 );
+        wait_idle;
+
+        // 2: byte masks, a write across a row boundary and a short write
+        write_burst( 'h11, 1, 2, 2'b10 );
+        write_burst( 'h64, 12, 2, 2'b11 );
+        write_burst( 'h20, 1, 2, 2'b01 );
+        write_burst( 'h200, 3, 2, 2'b11 );
+        wait_idle;
+
+        // 3: read back, appended and paused at the rows
+        for( idx = 0; idx < 16; idx = idx + 1 )
+            command( 1'b0, 'h10 + idx * 4, 4 );
+        command( 1'b0, 'h64, 12 );
+        command( 1'b0, 'h200, 3 );
+        wait_idle;
+
+        // every word of the memory, writes at the wrong clock land on the wrong words
+        for( idx = 0; idx < DEPTH; idx = idx + 1 ) begin
+            if( model.r_memory[idx] !== r_reference[idx] ) begin
+                $display( "memory %h is %h, expected %h", idx, model.r_memory[idx], r_reference[idx] );
+                r_errors = r_errors + 1;
+            end
+        end
+        if( r_max_words != MAX_BURST ) begin
+            $display( "longest burst %0d words, expected MAX_BURST %0d", r_max_words, MAX_BURST );
+            r_errors = r_errors + 1;
+        end
+        if( r_doubled == 0 ) begin
+            $display( "no write with the doubled latency" );
+            r_errors = r_errors + 1;
+        end
+        if( r_pauses == 0 ) begin
+            $display( "no read paused at a row" );
+            r_errors = r_errors + 1;
+        end
+        $display( "hyperram_tb: %0d reads, %0d doubled writes, %0d pause clocks, longest burst %0d words",
+            r_expect_read, r_doubled, r_pauses, r_max_words );
+        test_bench_finish;
+    end
+endmodule
@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	math_modular.v
+//
+// Project:	modular arithmetic
+//
+// Purpose:	Pipelined wrap around arithmetic, (I1 + I2) mod M, for ring buffer
+//          pointers, circular address generators and hashing.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// math_modular_add - sum = (I1 + I2) mod M
+//  I1 and I2 MUST BE less than M.
+//  The modulus is the parameter 'MODULUS', or the input 'M' when MODULUS = 0.
+//
+// Instead of adding then comparing and subtracting, both candidates are built at the same time.
+//  sum_wrap    = I1 + I2 + ~M + 1  = I1 + I2 - M
+//  sum_nowrap  = I1 + I2
+// The 3 operands of 'sum_wrap' are first reduced to 2 with a single carry save layer,
+// then both candidates are added with 'math_pipelined_add'. The adders are WIDTH+1 bits
+// wide, the msb of 'sum_wrap' is the final borrow and selects the result.
+// A new operation can be started every clock, the result is valid 'LATENCY' clocks later.
+module math_modular_add
+    #(
+        parameter WIDTH     = 4,
+        parameter LATENCY   = 2,
+        parameter MODULUS   = 0
+    )
+    (
+        input   wire                clk,
+        input   wire    [WIDTH-1:0] I1,
+        input   wire    [WIDTH-1:0] I2,
+        input   wire    [WIDTH-1:0] M,
+        output  wire    [WIDTH-1:0] sum
+    );
+    localparam [WIDTH:0] MODULUS_VALUE = MODULUS;
+    wire [WIDTH:0]  w_modulus = MODULUS != 0 ? MODULUS_VALUE : { 1'b0, M };
+    wire [WIDTH:0]  w_I1      = { 1'b0, I1 };
+    wire [WIDTH:0]  w_I2      = { 1'b0, I2 };
+    wire [WIDTH:0]  w_not_M   = ~w_modulus;
+
+    // carry save, I1 + I2 + ~M
+    wire [WIDTH:0]  w_csa_sum   = w_I1 ^ w_I2 ^ w_not_M;
+    wire [WIDTH:0]  w_csa_carry = { (w_I1[WIDTH-1:0] & w_I2[WIDTH-1:0]) | (w_I1[WIDTH-1:0] & w_not_M[WIDTH-1:0]) | (w_I2[WIDTH-1:0] & w_not_M[WIDTH-1:0]), 1'b0 };
+
+    wire [WIDTH:0]  w_sum_wrap;
+    wire [WIDTH:0]  w_sum_nowrap;
+    math_pipelined_add #( .WIDTH( WIDTH + 1 ), .LATENCY( LATENCY ) ) add_wrap
+    (
+        .clk(   clk ),
+        .I1(    w_csa_sum ),
+        .I2(    w_csa_carry ),
+        .cin(   1'b1 ),
+        .sum(   w_sum_wrap ),
+        .cout()
+    );
+    math_pipelined_add #( .WIDTH( WIDTH + 1 ), .LATENCY( LATENCY ) ) add_nowrap
+    (
+        .clk(   clk ),
+        .I1(    w_I1 ),
+        .I2(    w_I2 ),
+        .cin(   1'b0 ),
+        .sum(   w_sum_nowrap ),
+        .cout()
+    );
+    // a borrow means I1 + I2 < M, keep the unwrapped sum
+    assign sum = w_sum_wrap[WIDTH] ? w_sum_nowrap[WIDTH-1:0] : w_sum_wrap[WIDTH-1:0];
+endmodule
@@ -284,3 +284,338 @@ module math_pipelined
         end
     end
 endmodule
+
+
+// math_pipelined_add - {cout, sum} = I1 + I2 + cin
+// Unlike 'math_pipelined.sum' the inputs do not need to be held for 'LATENCY' clocks.
+// Each chunk is added in its own stage, the upper chunks of the operands and the
+// finished lower chunks of the sum travel down the pipeline with the carry.
+// A new operation can be started every clock, the result is valid exactly 'LATENCY'
+// clocks later. LATENCY = 0 is combinational
+//  WIDTH 12, LATENCY 3
+//  stage 0: sum[3:0]   = I1[3:0]   + I2[3:0]   + cin
+//  stage 1: sum[7:4]   = I1[7:4]   + I2[7:4]   + carry[0]
+//  stage 2: sum[11:8]  = I1[11:8]  + I2[11:8]  + carry[1]
+module math_pipelined_add
+    #(
+        parameter WIDTH     = 4,
+        parameter LATENCY   = 4
+    )
+    (
+        input   wire                clk,
+        input   wire    [WIDTH-1:0] I1,
+        input   wire    [WIDTH-1:0] I2,
+        input   wire                cin,
+        output  wire    [WIDTH-1:0] sum,
+        output  wire                cout
+    );
+    // same chunking as 'math_pipelined'
+    localparam ALU_WIDTH  = (LATENCY != 0) 
+        ? WIDTH / LATENCY * LATENCY == WIDTH 
+            ? WIDTH / LATENCY 
+            : WIDTH / LATENCY + 1 
+        : WIDTH; 
+    localparam CHUNK_COUNT = WIDTH % ALU_WIDTH == 0 ? WIDTH / ALU_WIDTH : WIDTH / ALU_WIDTH + 1; 
+    localparam LAST_CHUNK_SIZE = WIDTH % ALU_WIDTH == 0 ? ALU_WIDTH : WIDTH % ALU_WIDTH;
+
+    genvar idx;
+    generate
+        if( LATENCY == 0 ) begin
+            assign { cout, sum } = { 1'b0, I1 } + { 1'b0, I2 } + cin;
+        end else begin
+            // stage inputs, stage 0 is the module input
+            wire [WIDTH*(CHUNK_COUNT+1)-1:0]    w_I1;
+            wire [WIDTH*(CHUNK_COUNT+1)-1:0]    w_I2;
+            wire [WIDTH*(CHUNK_COUNT+1)-1:0]    w_sum;
+            wire [CHUNK_COUNT:0]                w_carry;
+            assign w_I1[WIDTH-1:0]  = I1;
+            assign w_I2[WIDTH-1:0]  = I2;
+            assign w_sum[WIDTH-1:0] = 'd0;
+            assign w_carry[0]       = cin;
+            for( idx = 0; idx < CHUNK_COUNT; idx = idx + 1 ) begin : add_stage_loop
+                localparam CHUNK_SIZE = idx != CHUNK_COUNT - 1 ? ALU_WIDTH : LAST_CHUNK_SIZE;
+                wire [CHUNK_SIZE:0] w_chunk = { 1'b0, w_I1[idx*WIDTH+idx*ALU_WIDTH+:CHUNK_SIZE] } 
+                                            + { 1'b0, w_I2[idx*WIDTH+idx*ALU_WIDTH+:CHUNK_SIZE] } 
+                                            + w_carry[idx];
+                // bits of the operands that have already been used are never read, and will be optimized away
+                reg [WIDTH-1:0] r_I1    = 0;
+                reg [WIDTH-1:0] r_I2    = 0;
+                reg [WIDTH-1:0] r_sum   = 0;
+                reg             r_carry = 0;
+                always @( posedge clk ) begin
+                    r_I1    <= w_I1[idx*WIDTH+:WIDTH];
+                    r_I2    <= w_I2[idx*WIDTH+:WIDTH];
+                    r_sum   <= w_sum[idx*WIDTH+:WIDTH];
+                    r_sum[idx*ALU_WIDTH+:CHUNK_SIZE] <= w_chunk[CHUNK_SIZE-1:0];
+                    r_carry <= w_chunk[CHUNK_SIZE];
+                end
+                assign w_I1[(idx+1)*WIDTH+:WIDTH]   = r_I1;
+                assign w_I2[(idx+1)*WIDTH+:WIDTH]   = r_I2;
+                assign w_sum[(idx+1)*WIDTH+:WIDTH]  = r_sum;
+                assign w_carry[idx+1]               = r_carry;
+            end
+            // pad the unused latency
+            ff_delay #( .WIDTH( WIDTH + 1 ), .DEPTH( LATENCY - CHUNK_COUNT ) ) add_delay 
+            ( 
+                .clk(   clk ), 
+                .D(     { w_carry[CHUNK_COUNT], w_sum[CHUNK_COUNT*WIDTH+:WIDTH] } ), 
+                .Q(     { cout, sum } ) 
+            );
+        end
+    endgenerate
+endmodule
+
+
+// math_pipelined_reduce - result = OPERATION I1, OPERATION is "AND", "OR" or "XOR"
+// The same N-ary tree as 'math_pipelined.gate_xor', but built directly on the bits of I1.
+// Each level of the tree only reads the level above it, so a new vector can be started
+// every clock. Any unused latency is added as a delay line so the result is valid exactly
+// 'LATENCY' clocks after the input. LATENCY = 0 is combinational
+module math_pipelined_reduce
+    #(
+        parameter WIDTH     = 4,
+        parameter LATENCY   = 2,
+        parameter OPERATION = "XOR"
+    )
+    (
+        input   wire                clk,
+        input   wire    [WIDTH-1:0] I1,
+        output  wire                result
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    genvar unit_index;
+    genvar input_index;
+    generate
+        if( LATENCY == 0 ) begin
+            if( OPERATION == "AND" )
+                assign result = &I1;
+            else if( OPERATION == "OR" )
+                assign result = |I1;
+            else
+                assign result = ^I1;
+        end else begin
+            localparam REDUCE_LUT_WIDTH     = f_NaryRecursionGetUnitWidthForLatency( WIDTH, LATENCY );  // use the maximum 'latency' to find the operator unit input width
+            localparam REDUCE_VECTOR_SIZE   = f_NaryRecursionGetVectorSize( WIDTH, REDUCE_LUT_WIDTH );  // use the operator input width to find how many units are needed
+            localparam REDUCE_DEPTH         = f_NaryRecursionGetDepth( WIDTH, REDUCE_LUT_WIDTH );       // actual latency of the tree
+            wire [WIDTH+REDUCE_VECTOR_SIZE-1:0] w_REDUCE;
+            assign w_REDUCE[WIDTH-1:0] = I1;
+            // loop through each unit and assign the in and outs
+            for( unit_index = 0; unit_index < REDUCE_VECTOR_SIZE; unit_index = unit_index + 1) begin : REDUCE_unit_loop
+                // make the input wires for this unit   
+                wire [f_NaryRecursionGetUnitWidth(WIDTH, REDUCE_LUT_WIDTH, unit_index)-1:0] unit_inputs;
+                // assign the inputs to their proper place
+                for( input_index = f_NaryRecursionGetUnitWidth(WIDTH, REDUCE_LUT_WIDTH, unit_index) - 1; input_index != ~0; input_index = input_index-1 ) begin : REDUCE_input_loop
+                        assign unit_inputs[input_index] = w_REDUCE[f_NaryRecursionGetUnitInputAddress(WIDTH, REDUCE_LUT_WIDTH, unit_index, input_index)];
+                end
+                // perform the function and store the output
+                reg r_REDUCE = 0;
+                if( OPERATION == "AND" )
+                    always @( posedge clk ) r_REDUCE <= &unit_inputs;
+                else if( OPERATION == "OR" )
+                    always @( posedge clk ) r_REDUCE <= |unit_inputs;
+                else
+                    always @( posedge clk ) r_REDUCE <= ^unit_inputs;
+                assign w_REDUCE[WIDTH+unit_index] = r_REDUCE;
+            end
+            // pad the unused latency
+            ff_delay #( .WIDTH( 1 ), .DEPTH( LATENCY - REDUCE_DEPTH ) ) reduce_delay ( .clk( clk ), .D( w_REDUCE[WIDTH+REDUCE_VECTOR_SIZE-1] ), .Q( result ) );
+        end
+    endgenerate
+endmodule
+
+
+// math_pipelined_multiply - product = I1 * I2
+//  SIGNED  - 1: I1, I2 and product are two's complement
+//  DSP     - 1: use the DSP multipliers. 0: build the multiplier from logic
+// LATENCY = 1 registers the product, LATENCY >= 2 also registers the inputs. The remaining
+// registers are placed after the product so the synthesizer can retime them into the
+// multiplier's pipeline registers. A new operation can be started every clock, the
+// product is valid exactly 'LATENCY' clocks later. LATENCY = 0 is combinational
+module math_pipelined_multiply
+    #(
+        parameter WIDTH_A   = 18,
+        parameter WIDTH_B   = 18,
+        parameter LATENCY   = 2,
+        parameter SIGNED    = 0,
+        parameter DSP       = 1
+    )
+    (
+        input   wire                        clk,
+        input   wire    [WIDTH_A-1:0]       I1,
+        input   wire    [WIDTH_B-1:0]       I2,
+        output  wire    [WIDTH_A+WIDTH_B-1:0] product
+    );
+    wire [WIDTH_A-1:0]          w_I1;
+    wire [WIDTH_B-1:0]          w_I2;
+    wire [WIDTH_A+WIDTH_B-1:0]  w_product;
+    generate
+        // input registers
+        if( LATENCY >= 2 ) begin
+            reg [WIDTH_A-1:0] r_I1 = 0;
+            reg [WIDTH_B-1:0] r_I2 = 0;
+            always @( posedge clk ) begin
+                r_I1 <= I1;
+                r_I2 <= I2;
+            end
+            assign w_I1 = r_I1;
+            assign w_I2 = r_I2;
+        end else begin
+            assign w_I1 = I1;
+            assign w_I2 = I2;
+        end
+        // multiplier
+        if( DSP ) begin
+            (* syn_dspstyle = "dsp" *) wire [WIDTH_A+WIDTH_B-1:0] w_mult;
+            if( SIGNED )
+                assign w_mult = $signed( w_I1 ) * $signed( w_I2 );
+            else
+                assign w_mult = w_I1 * w_I2;
+            assign w_product = w_mult;
+        end else begin
+            (* syn_dspstyle = "logic" *) wire [WIDTH_A+WIDTH_B-1:0] w_mult;
+            if( SIGNED )
+                assign w_mult = $signed( w_I1 ) * $signed( w_I2 );
+            else
+                assign w_mult = w_I1 * w_I2;
+            assign w_product = w_mult;
+        end
+        // output registers
+        if( LATENCY == 0 )
+            assign product = w_product;
+        else
+            ff_delay #( .WIDTH( WIDTH_A + WIDTH_B ), .DEPTH( LATENCY >= 2 ? LATENCY - 1 : 1 ) ) product_delay ( .clk( clk ), .D( w_product ), .Q( product ) );
+    endgenerate
+endmodule
+
+
+// math_pipelined_adder_tree - sum = I1[0] + I1[1] + ... + I1[COUNT-1]
+// I1 holds COUNT operands of WIDTH bits, operand n is I1[n*WIDTH+:WIDTH]. The sum is WIDTH bits,
+// the caller extends the operands to hold the growth of the sum, log2( COUNT ) bits.
+// The operands are added in the N-ary tree of 'math_pipelined_reduce', every unit is a registered
+// multi-operand add whose width is picked so the depth of the tree fits in 'LATENCY'.
+// A new set of operands can be started every clock, the sum is valid exactly 'LATENCY' clocks
+// after the input. LATENCY = 0 is combinational
+module math_pipelined_adder_tree
+    #(
+        parameter WIDTH     = 16,
+        parameter COUNT     = 8,
+        parameter LATENCY   = 2
+    )
+    (
+        input   wire                        clk,
+        input   wire    [COUNT*WIDTH-1:0]   I1,
+        output  wire    [WIDTH-1:0]         sum
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    genvar unit_index;
+    genvar input_index;
+    generate
+        if( LATENCY == 0 ) begin
+            wire [(COUNT+1)*WIDTH-1:0] w_partial;
+            assign w_partial[WIDTH-1:0] = 'd0;
+            for( input_index = 0; input_index < COUNT; input_index = input_index + 1 ) begin : TREE_sum_loop
+                assign w_partial[(input_index+1)*WIDTH+:WIDTH] = w_partial[input_index*WIDTH+:WIDTH] + I1[input_index*WIDTH+:WIDTH];
+            end
+            assign sum = w_partial[COUNT*WIDTH+:WIDTH];
+        end else begin
+            localparam TREE_UNIT_WIDTH  = f_NaryRecursionGetUnitWidthForLatency( COUNT, LATENCY );     // use the maximum 'latency' to find the operands per unit
+            localparam TREE_VECTOR_SIZE = f_NaryRecursionGetVectorSize( COUNT, TREE_UNIT_WIDTH );     // use the operands per unit to find how many units are needed
+            localparam TREE_DEPTH       = f_NaryRecursionGetDepth( COUNT, TREE_UNIT_WIDTH );          // actual latency of the tree
+            wire [(COUNT+TREE_VECTOR_SIZE)*WIDTH-1:0] w_TREE;
+            assign w_TREE[COUNT*WIDTH-1:0] = I1;
+            // loop through each unit and assign the in and outs
+            for( unit_index = 0; unit_index < TREE_VECTOR_SIZE; unit_index = unit_index + 1) begin : TREE_unit_loop
+                localparam UNIT_WIDTH = f_NaryRecursionGetUnitWidth( COUNT, TREE_UNIT_WIDTH, unit_index );
+                // running sum of the unit operands
+                wire [(UNIT_WIDTH+1)*WIDTH-1:0] w_partial;
+                assign w_partial[WIDTH-1:0] = 'd0;
+                for( input_index = 0; input_index < UNIT_WIDTH; input_index = input_index + 1 ) begin : TREE_input_loop
+                    assign w_partial[(input_index+1)*WIDTH+:WIDTH] = w_partial[input_index*WIDTH+:WIDTH]
+                        + w_TREE[f_NaryRecursionGetUnitInputAddress(COUNT, TREE_UNIT_WIDTH, unit_index, input_index)*WIDTH+:WIDTH];
+                end
+                // store the unit sum
+                reg [WIDTH-1:0] r_TREE = 0;
+                always @( posedge clk ) r_TREE <= w_partial[UNIT_WIDTH*WIDTH+:WIDTH];
+                assign w_TREE[(COUNT+unit_index)*WIDTH+:WIDTH] = r_TREE;
+            end
+            // pad the unused latency
+            ff_delay #( .WIDTH( WIDTH ), .DEPTH( LATENCY - TREE_DEPTH ) ) tree_delay ( .clk( clk ), .D( w_TREE[(COUNT+TREE_VECTOR_SIZE-1)*WIDTH+:WIDTH] ), .Q( sum ) );
+        end
+    endgenerate
+endmodule
+
+
+// math_pipelined_accumulator - sum + carries += I1 every 'enable' clock
+// The accumulator is kept in carry save form, each ALU_WIDTH chunk registers its carry out and
+// adds it into the next chunk on the next clock, so the carries never ripple and any WIDTH
+// accumulates every clock. The top carry is dropped, the sum wraps at WIDTH bits.
+//  restart     - the accumulator starts over from I1, 0 + I1, instead of adding to the old value
+//  clear       - the accumulator is set to 0, clear wins over enable
+//  next_sum, next_carries  - the value loaded on 'enable', carry idx is the carry out of chunk idx
+//  sum, carries            - the accumulator, carries are at their bit positions, the value is sum + carries
+// sum + carries can be resolved by a 'math_pipelined_add'.
+module math_pipelined_accumulator
+    #(
+        parameter WIDTH         = 32,
+        parameter ALU_WIDTH     = 8,
+        // do not override
+        parameter CHUNK_COUNT   = WIDTH % ALU_WIDTH == 0 ? WIDTH / ALU_WIDTH : WIDTH / ALU_WIDTH + 1
+    )
+    (
+        input   wire                        clk,
+        input   wire                        clear,
+        input   wire                        enable,
+        input   wire                        restart,
+        input   wire    [WIDTH-1:0]         I1,
+        output  wire    [WIDTH-1:0]         next_sum,
+        output  wire    [CHUNK_COUNT-1:0]   next_carries,
+        output  wire    [WIDTH-1:0]         sum,
+        output  wire    [WIDTH-1:0]         carries
+    );
+    localparam LAST_CHUNK_SIZE = WIDTH % ALU_WIDTH == 0 ? ALU_WIDTH : WIDTH % ALU_WIDTH;
+
+    reg  [WIDTH-1:0]        r_sum       = 0;
+    reg  [CHUNK_COUNT-1:0]  r_carries   = 0;
+    assign sum = r_sum;
+    genvar idx;
+    generate
+        for( idx = 0; idx < CHUNK_COUNT; idx = idx + 1 ) begin : acc_chunk_loop
+            localparam CHUNK_SIZE = idx != CHUNK_COUNT - 1 ? ALU_WIDTH : LAST_CHUNK_SIZE;
+            wire w_carry_in;
+            if( idx == 0 )
+                assign w_carry_in = 1'b0;
+            else
+                assign w_carry_in = ~restart & r_carries[idx-1];
+            assign { next_carries[idx], next_sum[idx*ALU_WIDTH+:CHUNK_SIZE] } =
+                  { 1'b0, restart ? { CHUNK_SIZE{1'b0} } : r_sum[idx*ALU_WIDTH+:CHUNK_SIZE] }
+                + { 1'b0, I1[idx*ALU_WIDTH+:CHUNK_SIZE] }
+                + w_carry_in;
+        end
+        // the carry out of chunk idx belongs to the lsb of chunk idx + 1
+        for( idx = 0; idx < WIDTH; idx = idx + 1 ) begin : carry_position_loop
+            if( idx % ALU_WIDTH == 0 && idx != 0 )
+                assign carries[idx] = r_carries[idx/ALU_WIDTH-1];
+            else
+                assign carries[idx] = 1'b0;
+        end
+    endgenerate
+
+    always @( posedge clk ) begin
+        if( enable ) begin
+            r_sum       <= next_sum;
+            r_carries   <= next_carries;
+        end
+        if( clear ) begin
+            r_sum       <= 'd0;
+            r_carries   <= 'd0;
+        end
+    end
+endmodule
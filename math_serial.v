@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	math_serial.v
+//
+// Project:	math serial
+//
+// Purpose:	Digit serial versions of the math_pipelined operations, for many
+//          low rate channels in as few LUTs as possible.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// The digit width is the 'ALU_WIDTH' of 'math_pipelined' with the same WIDTH and LATENCY,
+// a WIDTH bit word is CHUNK_COUNT <= LATENCY digits, least significant digit first.
+// Where 'math_pipelined' spends 1 ALU_WIDTH chunk per clock in parallel hardware, 'math_serial'
+// reuses a single chunk for CHUNK_COUNT clocks. WIDTH 32, LATENCY 8 is a 4 bit digit, 1/8 serial.
+//  math_serial_serializer   - WIDTH bit word to digits, with first and last digit strobes
+//  math_serial              - digit serial operations
+//  math_serial_deserializer - digits to a WIDTH bit word
+
+// math_serial - digit serial add, sub, reductions and compares
+//  'first' and 'last' mark the first and last digits of a word, 'first' clears the carries and
+//  the word state. The digits of sum and sub are 1 clock behind the input digits, out_first
+//  and out_last are first and last delayed to match so math_serial units can be chained.
+//  The word results are valid while out_last is set.
+//  sum         = I1 + I2
+//  sub         = I1 - I2
+//  gate_and    = &I1
+//  gate_or     = |I1
+//  gate_xor    = ^I1
+//  cmp_eq      = I1 == I3
+//  cmp_neq     = I1 != I3
+//  cmp_greater = I1 > I3
+//  cmp_lesser  = I1 < I3
+module math_serial
+    #(
+        parameter WIDTH     = 32,
+        parameter LATENCY   = 8,
+        // same chunking as 'math_pipelined', do not override
+        parameter ALU_WIDTH = (LATENCY != 0)
+            ? WIDTH / LATENCY * LATENCY == WIDTH
+                ? WIDTH / LATENCY
+                : WIDTH / LATENCY + 1
+            : WIDTH
+    )
+    (
+        input   wire                    clk,
+        input   wire                    rst,
+        input   wire                    first,
+        input   wire                    last,
+        input   wire    [ALU_WIDTH-1:0] I1,
+        input   wire    [ALU_WIDTH-1:0] I2,
+        input   wire    [ALU_WIDTH-1:0] I3,
+        output  wire                    out_first,
+        output  wire                    out_last,
+        output  wire    [ALU_WIDTH-1:0] sum,
+        output  wire    [ALU_WIDTH-1:0] sub,
+        output  wire                    gate_and,
+        output  wire                    gate_or,
+        output  wire                    gate_xor,
+        output  wire                    cmp_eq,
+        output  wire                    cmp_neq,
+        output  wire                    cmp_greater,
+        output  wire                    cmp_lesser
+    );
+    localparam LAST_CHUNK_SIZE = WIDTH % ALU_WIDTH == 0 ? ALU_WIDTH : WIDTH % ALU_WIDTH;
+    // the bits of the last digit that are above WIDTH are ignored
+    localparam [ALU_WIDTH-1:0] LAST_MASK = ~( { ALU_WIDTH{1'b1} } << LAST_CHUNK_SIZE );
+
+    wire [ALU_WIDTH-1:0] w_mask    = last ? LAST_MASK : { ALU_WIDTH{1'b1} };
+    wire [ALU_WIDTH-1:0] w_I1      = I1 & w_mask;
+    wire [ALU_WIDTH-1:0] w_I3      = I3 & w_mask;
+
+    reg [ALU_WIDTH-1:0] r_sum       = 0;
+    reg [ALU_WIDTH-1:0] r_sub       = 0;
+    reg                 r_sum_carry = 0;
+    reg                 r_sub_carry = 0;    // 1 = no borrow
+    reg                 r_first     = 0;
+    reg                 r_last      = 0;
+    reg                 r_and       = 0;
+    reg                 r_or        = 0;
+    reg                 r_xor       = 0;
+    reg                 r_eq        = 0;
+    reg                 r_greater   = 0;
+    reg                 r_lesser    = 0;
+    assign sum          = r_sum;
+    assign sub          = r_sub;
+    assign out_first    = r_first;
+    assign out_last     = r_last;
+    assign gate_and     = r_and;
+    assign gate_or      = r_or;
+    assign gate_xor     = r_xor;
+    assign cmp_eq       = r_eq;
+    assign cmp_neq      = ~r_eq;
+    assign cmp_greater  = r_greater;
+    assign cmp_lesser   = r_lesser;
+
+    wire w_greater  = w_I1 > w_I3;
+    wire w_lesser   = w_I1 < w_I3;
+    always @( posedge clk ) begin
+        { r_sum_carry, r_sum } <= { 1'b0, I1 } + { 1'b0, I2 } + ( first ? 1'b0 : r_sum_carry );
+        { r_sub_carry, r_sub } <= { 1'b0, I1 } + { 1'b0, ~I2 } + ( first ? 1'b1 : r_sub_carry );
+        r_and   <= ( first | r_and ) & &( w_I1 | ~w_mask );
+        r_or    <= ( ~first & r_or ) | |w_I1;
+        r_xor   <= ( ~first & r_xor ) ^ ^w_I1;
+        r_eq    <= ( first | r_eq ) & ( w_I1 == w_I3 );
+        // the most significant digit that differs decides
+        if( w_greater || w_lesser ) begin
+            r_greater   <= w_greater;
+            r_lesser    <= w_lesser;
+        end else if( first ) begin
+            r_greater   <= 1'b0;
+            r_lesser    <= 1'b0;
+        end
+        if( rst ) begin
+            r_first     <= 1'b0;
+            r_last      <= 1'b0;
+        end else begin
+            r_first     <= first;
+            r_last      <= last;
+        end
+    end
+endmodule
+
+// math_serial_serializer - splits I1 into digits, least significant first
+//  A word is accepted when 'load' is set and 'ready' is set, the next word can be loaded on
+//  the clock of the last digit so back to back words have no gaps.
+module math_serial_serializer
+    #(
+        parameter WIDTH     = 32,
+        parameter LATENCY   = 8,
+        // same chunking as 'math_pipelined', do not override
+        parameter ALU_WIDTH = (LATENCY != 0)
+            ? WIDTH / LATENCY * LATENCY == WIDTH
+                ? WIDTH / LATENCY
+                : WIDTH / LATENCY + 1
+            : WIDTH
+    )
+    (
+        input   wire                    clk,
+        input   wire                    rst,
+        input   wire                    load,
+        input   wire    [WIDTH-1:0]     I1,
+        output  wire                    ready,
+        output  wire                    valid,
+        output  wire                    first,
+        output  wire                    last,
+        output  wire    [ALU_WIDTH-1:0] digit
+    );
+    localparam CHUNK_COUNT = WIDTH % ALU_WIDTH == 0 ? WIDTH / ALU_WIDTH : WIDTH / ALU_WIDTH + 1;
+
+    // one hot digit position, no counter to decode
+    reg [CHUNK_COUNT-1:0]           r_phase = 0;
+    reg [CHUNK_COUNT*ALU_WIDTH-1:0] r_word  = 0;
+    assign ready    = ~|r_phase | r_phase[CHUNK_COUNT-1];
+    assign valid    = |r_phase;
+    assign first    = r_phase[0];
+    assign last     = r_phase[CHUNK_COUNT-1];
+    assign digit    = r_word[ALU_WIDTH-1:0];
+    always @( posedge clk ) begin
+        if( load && ready )
+            r_word  <= I1;
+        else
+            r_word  <= r_word >> ALU_WIDTH;
+        if( rst )
+            r_phase <= 'd0;
+        else
+            r_phase <= ( ( r_phase << 1 ) & { CHUNK_COUNT{~r_phase[CHUNK_COUNT-1]} } ) | ( load && ready );
+    end
+endmodule
+
+// math_serial_deserializer - collects digits, least significant first, into a word
+//  word is valid for the clock after 'last'
+module math_serial_deserializer
+    #(
+        parameter WIDTH     = 32,
+        parameter LATENCY   = 8,
+        // same chunking as 'math_pipelined', do not override
+        parameter ALU_WIDTH = (LATENCY != 0)
+            ? WIDTH / LATENCY * LATENCY == WIDTH
+                ? WIDTH / LATENCY
+                : WIDTH / LATENCY + 1
+            : WIDTH
+    )
+    (
+        input   wire                    clk,
+        input   wire                    rst,
+        input   wire                    last,
+        input   wire    [ALU_WIDTH-1:0] digit,
+        output  wire                    valid,
+        output  wire    [WIDTH-1:0]     word
+    );
+    localparam CHUNK_COUNT = WIDTH % ALU_WIDTH == 0 ? WIDTH / ALU_WIDTH : WIDTH / ALU_WIDTH + 1;
+
+    wire [CHUNK_COUNT*ALU_WIDTH-1:0] w_digit = digit;
+    reg  [CHUNK_COUNT*ALU_WIDTH-1:0] r_word  = 0;
+    reg                              r_valid = 0;
+    assign valid    = r_valid;
+    assign word     = r_word[WIDTH-1:0];
+    always @( posedge clk ) begin
+        r_word <= ( r_word >> ALU_WIDTH ) | ( w_digit << ( (CHUNK_COUNT-1) * ALU_WIDTH ) );
+        if( rst )
+            r_valid <= 1'b0;
+        else
+            r_valid <= last;
+    end
+endmodule
@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	math_sqrt.v
+//
+// Project:	math sqrt
+//
+// Purpose:	Non-restoring integer square root, unrolled for 1 result per
+//          clock or iterative for minimal area.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// math_sqrt - result = floor( sqrt( I1 ) )
+//  WIDTH       - input width, MUST BE even and >= 4. result is WIDTH / 2 bits
+//  LATENCY     - the root bits are produced 'STAGES' = ceil( WIDTH / 2 / LATENCY ) per clock
+//  ITERATIVE   - 0: the stage groups are unrolled, 1 result per clock. in_ready is always 1
+//                   result is valid exactly 'LATENCY' clocks after in_valid, LATENCY 0 is combinational
+//                1: a single stage group is reused, 1 result every GROUPS + 1 clocks
+//                   result is valid GROUPS + 1 clocks after in_valid & in_ready
+//
+// Each root bit is one non-restoring stage, the sign of the partial remainder picks between
+// adding or subtracting the partial root. The sign is the carry out of the whole stage so
+// the stages can not overlap, they are grouped 'STAGES' per clock instead.
+module math_sqrt
+    #(
+        parameter WIDTH     = 32,
+        parameter LATENCY   = 4,
+        parameter ITERATIVE = 0
+    )
+    (
+        input   wire                    clk,
+        input   wire                    rst,
+        input   wire                    in_valid,
+        output  wire                    in_ready,
+        input   wire    [WIDTH-1:0]     I1,
+        output  wire                    out_valid,
+        output  wire    [WIDTH/2-1:0]   result
+    );
+    localparam ROOT_WIDTH   = WIDTH / 2;
+    localparam STAGES       = (LATENCY != 0)
+        ? ROOT_WIDTH / LATENCY * LATENCY == ROOT_WIDTH
+            ? ROOT_WIDTH / LATENCY
+            : ROOT_WIDTH / LATENCY + 1
+        : ROOT_WIDTH;
+    localparam GROUPS       = ROOT_WIDTH % STAGES == 0 ? ROOT_WIDTH / STAGES : ROOT_WIDTH / STAGES + 1;
+    // leading zero bit pairs fill the first group, they leave the root unchanged
+    localparam D_WIDTH      = 2 * GROUPS * STAGES;
+    localparam R_WIDTH      = ROOT_WIDTH + 2;
+
+    wire [D_WIDTH-1:0] w_d = I1;
+
+    genvar idx;
+    generate
+        if( ITERATIVE ) begin
+            reg [R_WIDTH-1:0]       r_r         = 0;
+            reg [ROOT_WIDTH-1:0]    r_q         = 0;
+            reg [D_WIDTH-1:0]       r_d         = 0;
+            reg [GROUPS-1:0]        r_pass      = 0;
+            reg [ROOT_WIDTH-1:0]    r_result    = 0;
+            reg                     r_out_valid = 0;
+            wire [R_WIDTH-1:0]      w_r;
+            wire [ROOT_WIDTH-1:0]   w_q;
+            math_sqrt_group #( .WIDTH( ROOT_WIDTH ), .STAGES( STAGES ) ) sqrt_group
+            (
+                .r_in(  r_r ),
+                .q_in(  r_q ),
+                .d_in(  r_d[D_WIDTH-1-:2*STAGES] ),
+                .r_out( w_r ),
+                .q_out( w_q )
+            );
+            assign in_ready     = ~|r_pass;
+            assign out_valid    = r_out_valid;
+            assign result       = r_result;
+            always @( posedge clk ) begin
+                if( in_valid && in_ready ) begin
+                    r_r <= 'd0;
+                    r_q <= 'd0;
+                    r_d <= w_d;
+                end else begin
+                    r_r <= w_r;
+                    r_q <= w_q;
+                    r_d <= r_d << ( 2 * STAGES );
+                end
+                if( r_pass[GROUPS-1] )
+                    r_result <= w_q;
+                if( rst ) begin
+                    r_pass      <= 'd0;
+                    r_out_valid <= 1'b0;
+                end else begin
+                    r_pass      <= ( r_pass << 1 ) | ( in_valid && in_ready );
+                    r_out_valid <= r_pass[GROUPS-1];
+                end
+            end
+        end else begin
+            // group inputs, group 0 is the module input
+            wire [R_WIDTH*(GROUPS+1)-1:0]       w_r;
+            wire [ROOT_WIDTH*(GROUPS+1)-1:0]    w_q;
+            wire [D_WIDTH*(GROUPS+1)-1:0]       w_dd;
+            assign w_r[R_WIDTH-1:0]     = 'd0;
+            assign w_q[ROOT_WIDTH-1:0]  = 'd0;
+            assign w_dd[D_WIDTH-1:0]    = w_d;
+            for( idx = 0; idx < GROUPS; idx = idx + 1 ) begin : sqrt_group_loop
+                wire [R_WIDTH-1:0]      w_group_r;
+                wire [ROOT_WIDTH-1:0]   w_group_q;
+                math_sqrt_group #( .WIDTH( ROOT_WIDTH ), .STAGES( STAGES ) ) sqrt_group
+                (
+                    .r_in(  w_r[idx*R_WIDTH+:R_WIDTH] ),
+                    .q_in(  w_q[idx*ROOT_WIDTH+:ROOT_WIDTH] ),
+                    .d_in(  w_dd[idx*D_WIDTH+D_WIDTH-1-:2*STAGES] ),
+                    .r_out( w_group_r ),
+                    .q_out( w_group_q )
+                );
+                if( LATENCY == 0 ) begin
+                    assign w_r[(idx+1)*R_WIDTH+:R_WIDTH]            = w_group_r;
+                    assign w_q[(idx+1)*ROOT_WIDTH+:ROOT_WIDTH]      = w_group_q;
+                    assign w_dd[(idx+1)*D_WIDTH+:D_WIDTH]           = w_dd[idx*D_WIDTH+:D_WIDTH] << ( 2 * STAGES );
+                end else begin
+                    // bits of the input that have already been used are never read, and will be optimized away
+                    reg [R_WIDTH-1:0]       r_r = 0;
+                    reg [ROOT_WIDTH-1:0]    r_q = 0;
+                    reg [D_WIDTH-1:0]       r_d = 0;
+                    always @( posedge clk ) begin
+                        r_r <= w_group_r;
+                        r_q <= w_group_q;
+                        r_d <= w_dd[idx*D_WIDTH+:D_WIDTH] << ( 2 * STAGES );
+                    end
+                    assign w_r[(idx+1)*R_WIDTH+:R_WIDTH]            = r_r;
+                    assign w_q[(idx+1)*ROOT_WIDTH+:ROOT_WIDTH]      = r_q;
+                    assign w_dd[(idx+1)*D_WIDTH+:D_WIDTH]           = r_d;
+                end
+            end
+            assign in_ready = 1'b1;
+            if( LATENCY == 0 ) begin
+                assign result       = w_q[GROUPS*ROOT_WIDTH+:ROOT_WIDTH];
+                assign out_valid    = in_valid;
+            end else begin
+                reg [LATENCY-1:0] r_valid = 0;
+                assign out_valid = r_valid[LATENCY-1];
+                always @( posedge clk ) begin
+                    if( rst )
+                        r_valid <= 'd0;
+                    else
+                        r_valid <= ( r_valid << 1 ) | in_valid;
+                end
+                // pad the unused latency
+                ff_delay #( .WIDTH( ROOT_WIDTH ), .DEPTH( LATENCY - GROUPS ) ) result_delay
+                (
+                    .clk(   clk ),
+                    .D(     w_q[GROUPS*ROOT_WIDTH+:ROOT_WIDTH] ),
+                    .Q(     result )
+                );
+            end
+        end
+    endgenerate
+endmodule
+
+// math_sqrt_group - 'STAGES' combinational non-restoring square root stages
+//  r is the signed partial remainder, q is the partial root, d_in is the next 2 * STAGES bits
+//  of the radicand, most significant pair first.
+//      r >= 0:  r = 4r + d - ( 4q + 1 )
+//      r <  0:  r = 4r + d + ( 4q + 3 )
+//      q = 2q + ( r >= 0 )
+module math_sqrt_group
+    #(
+        parameter WIDTH     = 16,
+        parameter STAGES    = 4
+    )
+    (
+        input   wire    [WIDTH+1:0]     r_in,
+        input   wire    [WIDTH-1:0]     q_in,
+        input   wire    [2*STAGES-1:0]  d_in,
+        output  wire    [WIDTH+1:0]     r_out,
+        output  wire    [WIDTH-1:0]     q_out
+    );
+    // stage inputs, stage 0 is the module input
+    wire [(WIDTH+2)*(STAGES+1)-1:0] w_r;
+    wire [WIDTH*(STAGES+1)-1:0]     w_q;
+    assign w_r[WIDTH+1:0]   = r_in;
+    assign w_q[WIDTH-1:0]   = q_in;
+    assign r_out            = w_r[STAGES*(WIDTH+2)+:WIDTH+2];
+    assign q_out            = w_q[STAGES*WIDTH+:WIDTH];
+    genvar idx;
+    generate
+        for( idx = 0; idx < STAGES; idx = idx + 1 ) begin : sqrt_stage_loop
+            wire [WIDTH+1:0]    w_stage_r   = w_r[idx*(WIDTH+2)+:WIDTH+2];
+            wire [WIDTH-1:0]    w_stage_q   = w_q[idx*WIDTH+:WIDTH];
+            wire                w_negative  = w_stage_r[WIDTH+1];
+            wire [WIDTH+1:0]    w_sum;
+            // the remainder never needs more than WIDTH + 2 bits, the bits shifted out are sign bits
+            math_pipelined_add #( .WIDTH( WIDTH + 2 ), .LATENCY( 0 ) ) stage_add
+            (
+                .clk(   1'b0 ),
+                .I1(    { w_stage_r[WIDTH-1:0], d_in[2*(STAGES-idx)-1-:2] } ),
+                .I2(    w_negative ? { w_stage_q, 2'b11 } : ~{ w_stage_q, 2'b01 } ),
+                .cin(   ~w_negative ),
+                .sum(   w_sum ),
+                .cout()
+            );
+            assign w_r[(idx+1)*(WIDTH+2)+:WIDTH+2]  = w_sum;
+            assign w_q[(idx+1)*WIDTH+:WIDTH]        = { w_stage_q[WIDTH-2:0], ~w_sum[WIDTH+1] };
+        end
+    endgenerate
+endmodule
@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	multiport_memory.v
+//
+// Project:	multiport memory
+//
+// Purpose:	Memory with several write and read ports per clock, built from
+//          1 write 1 read memory_pipelined banks with a live value table or
+//          xor banking.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// multiport_memory - WRITE_PORTS writes and READ_PORTS reads every clock
+//  port n uses write_enable[n], write_address[n*ADDRESS_WIDTH+:ADDRESS_WIDTH] and write_data[n*DATA_WIDTH+:DATA_WIDTH],
+//  read port n uses read_address[n*ADDRESS_WIDTH+:ADDRESS_WIDTH] and read_data[n*DATA_WIDTH+:DATA_WIDTH].
+//  read_data is valid exactly LATENCY = MEM_LATENCY + 1 clocks after read_address, the banks take MEM_LATENCY
+//  and the LVT / XOR select takes 1. MEM_LATENCY is the memory_pipelined LATENCY and MUST BE >= 1.
+//  When several ports write the same address on the same clock the highest port wins, the others are dropped.
+//  SCHEME
+//      "LVT"   every write port has a row of READ_PORTS banks, 1 per read port, written together.
+//              The live value table, registers, remembers which write port wrote each address last
+//              and picks that port's bank for every read. The table read is a mux tree split into
+//              MEM_LATENCY registered stages beside the banks, each resolving ADDRESS_WIDTH / MEM_LATENCY
+//              address bits, so a deep table needs a larger MEM_LATENCY, not a longer clock.
+//              Banks: WRITE_PORTS * READ_PORTS
+//              A write is seen by reads started 1 clock later.
+//      "XOR"   every write port has a row of banks that store data ^ the other rows at that address,
+//              so a read is the xor of 1 bank from every row and needs no table. The other rows are
+//              read when the write is taken and the write is committed MEM_LATENCY clocks later.
+//              Commits to the same address by other ports while the write was waiting are forwarded
+//              from a short history of each port's commits. Banks: WRITE_PORTS * ( WRITE_PORTS - 1 + READ_PORTS )
+//              A write is seen by reads started MEM_LATENCY + 1 clocks later.
+module multiport_memory
+    #(
+        parameter WRITE_PORTS   = 2,
+        parameter READ_PORTS    = 4,
+        parameter DATA_WIDTH    = 32,
+        parameter DEPTH         = 512,
+        parameter ADDRESS_WIDTH = 9,
+        parameter SCHEME        = "LVT",
+        parameter MEM_LATENCY   = 1,
+        parameter STYLE         = "block_ram"
+    )
+    (
+        input   wire                                    clk,
+        input   wire    [WRITE_PORTS-1:0]               write_enable,
+        input   wire    [WRITE_PORTS*ADDRESS_WIDTH-1:0] write_address,
+        input   wire    [WRITE_PORTS*DATA_WIDTH-1:0]    write_data,
+        input   wire    [READ_PORTS*ADDRESS_WIDTH-1:0]  read_address,
+        output  wire    [READ_PORTS*DATA_WIDTH-1:0]     read_data
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    localparam LVT_WIDTH = f_Log2( WRITE_PORTS );
+
+    genvar port, other, bank, stage;
+
+    // drop writes that a higher port overrides on the same clock
+    wire [WRITE_PORTS-1:0] w_write_enable;
+    generate
+        for( port = 0; port < WRITE_PORTS; port = port + 1 ) begin : write_priority_loop
+            wire [WRITE_PORTS-1:0] w_overridden;
+            for( other = 0; other < WRITE_PORTS; other = other + 1 ) begin : write_compare_loop
+                if( other > port )
+                    assign w_overridden[other] = write_enable[other] && write_address[other*ADDRESS_WIDTH+:ADDRESS_WIDTH] == write_address[port*ADDRESS_WIDTH+:ADDRESS_WIDTH];
+                else
+                    assign w_overridden[other] = 1'b0;
+            end
+            assign w_write_enable[port] = write_enable[port] && !w_overridden;
+        end
+    endgenerate
+
+    generate
+        if( SCHEME == "XOR" ) begin
+            localparam BANKS = WRITE_PORTS - 1 + READ_PORTS;   // feedback banks first, then the read banks
+            // bank outputs, [write port][bank]
+            wire [WRITE_PORTS*BANKS*DATA_WIDTH-1:0] w_bank_read;
+            // the delayed writes
+            wire [WRITE_PORTS-1:0]                  w_commit;
+            wire [WRITE_PORTS*ADDRESS_WIDTH-1:0]    w_commit_address;
+            wire [WRITE_PORTS*DATA_WIDTH-1:0]       w_commit_data;
+            // the value each port commits, data ^ the other rows
+            wire [WRITE_PORTS*DATA_WIDTH-1:0]       w_commit_value;
+            // commit history of the last MEM_LATENCY clocks, newest first
+            wire [WRITE_PORTS*MEM_LATENCY-1:0]                  w_history_valid;
+            wire [WRITE_PORTS*MEM_LATENCY*ADDRESS_WIDTH-1:0]    w_history_address;
+            wire [WRITE_PORTS*MEM_LATENCY*DATA_WIDTH-1:0]       w_history_value;
+
+            for( port = 0; port < WRITE_PORTS; port = port + 1 ) begin : xor_row_loop
+                ff_delay #( .WIDTH( 1 + ADDRESS_WIDTH + DATA_WIDTH ), .DEPTH( MEM_LATENCY ) ) write_delay
+                (
+                    .clk(   clk ),
+                    .D(     { w_write_enable[port], write_address[port*ADDRESS_WIDTH+:ADDRESS_WIDTH], write_data[port*DATA_WIDTH+:DATA_WIDTH] } ),
+                    .Q(     { w_commit[port], w_commit_address[port*ADDRESS_WIDTH+:ADDRESS_WIDTH], w_commit_data[port*DATA_WIDTH+:DATA_WIDTH] } )
+                );
+                // history
+                reg [MEM_LATENCY-1:0]               r_history_valid     = 0;
+                reg [MEM_LATENCY*ADDRESS_WIDTH-1:0] r_history_address   = 0;
+                reg [MEM_LATENCY*DATA_WIDTH-1:0]    r_history_value     = 0;
+                always @( posedge clk ) begin
+                    r_history_valid     <= ( r_history_valid << 1 ) | w_commit[port];
+                    r_history_address   <= ( r_history_address << ADDRESS_WIDTH ) | w_commit_address[port*ADDRESS_WIDTH+:ADDRESS_WIDTH];
+                    r_history_value     <= ( r_history_value << DATA_WIDTH ) | w_commit_value[port*DATA_WIDTH+:DATA_WIDTH];
+                end
+                assign w_history_valid[port*MEM_LATENCY+:MEM_LATENCY]                               = r_history_valid;
+                assign w_history_address[port*MEM_LATENCY*ADDRESS_WIDTH+:MEM_LATENCY*ADDRESS_WIDTH] = r_history_address;
+                assign w_history_value[port*MEM_LATENCY*DATA_WIDTH+:MEM_LATENCY*DATA_WIDTH]         = r_history_value;
+
+                // the other rows at the commit address, the feedback bank of 'port' in row 'other'
+                // is bank port - ( port > other )
+                wire [(WRITE_PORTS+1)*DATA_WIDTH-1:0] w_others;
+                assign w_others[DATA_WIDTH-1:0] = w_commit_data[port*DATA_WIDTH+:DATA_WIDTH];
+                for( other = 0; other < WRITE_PORTS; other = other + 1 ) begin : xor_feedback_loop
+                    if( other == port ) begin
+                        assign w_others[(other+1)*DATA_WIDTH+:DATA_WIDTH] = w_others[other*DATA_WIDTH+:DATA_WIDTH];
+                    end else begin
+                        localparam FEEDBACK_BANK = port - ( port > other ? 1 : 0 );
+                        // forward the newest commit of 'other' to this address that the bank read missed
+                        reg [DATA_WIDTH-1:0] w_other_value;
+                        integer age;
+                        always @(*) begin
+                            w_other_value = w_bank_read[(other*BANKS+FEEDBACK_BANK)*DATA_WIDTH+:DATA_WIDTH];
+                            for( age = MEM_LATENCY - 1; age >= 0; age = age - 1 )
+                                if( w_history_valid[other*MEM_LATENCY+age]
+                                 && w_history_address[(other*MEM_LATENCY+age)*ADDRESS_WIDTH+:ADDRESS_WIDTH] == w_commit_address[port*ADDRESS_WIDTH+:ADDRESS_WIDTH] )
+                                    w_other_value = w_history_value[(other*MEM_LATENCY+age)*DATA_WIDTH+:DATA_WIDTH];
+                        end
+                        assign w_others[(other+1)*DATA_WIDTH+:DATA_WIDTH] = w_others[other*DATA_WIDTH+:DATA_WIDTH] ^ w_other_value;
+                    end
+                end
+                assign w_commit_value[port*DATA_WIDTH+:DATA_WIDTH] = w_others[WRITE_PORTS*DATA_WIDTH+:DATA_WIDTH];
+
+                // the row, feedback banks are read at the write address of the other ports
+                for( bank = 0; bank < BANKS; bank = bank + 1 ) begin : xor_bank_loop
+                    wire [ADDRESS_WIDTH-1:0] w_read_address;
+                    if( bank < WRITE_PORTS - 1 ) begin
+                        localparam READER = bank + ( bank >= port ? 1 : 0 );
+                        assign w_read_address = write_address[READER*ADDRESS_WIDTH+:ADDRESS_WIDTH];
+                    end else begin
+                        assign w_read_address = read_address[(bank-WRITE_PORTS+1)*ADDRESS_WIDTH+:ADDRESS_WIDTH];
+                    end
+                    memory_pipelined
+                        #(
+                            .DATA_WIDTH(    DATA_WIDTH ),
+                            .DEPTH(         DEPTH ),
+                            .ADDRESS_WIDTH( ADDRESS_WIDTH ),
+                            .LATENCY(       MEM_LATENCY ),
+                            .STYLE(         STYLE )
+                        )
+                        xor_bank
+                        (
+                            .clk(           clk ),
+                            .write_enable(  w_commit[port] ),
+                            .write_address( w_commit_address[port*ADDRESS_WIDTH+:ADDRESS_WIDTH] ),
+                            .write_data(    w_commit_value[port*DATA_WIDTH+:DATA_WIDTH] ),
+                            .read_address(  w_read_address ),
+                            .read_data(     w_bank_read[(port*BANKS+bank)*DATA_WIDTH+:DATA_WIDTH] )
+                        );
+                end
+            end
+
+            // read ports, the xor of the read bank of every row
+            for( port = 0; port < READ_PORTS; port = port + 1 ) begin : xor_read_loop
+                wire [(WRITE_PORTS+1)*DATA_WIDTH-1:0] w_xor;
+                assign w_xor[DATA_WIDTH-1:0] = 'd0;
+                for( other = 0; other < WRITE_PORTS; other = other + 1 ) begin : xor_read_row_loop
+                    assign w_xor[(other+1)*DATA_WIDTH+:DATA_WIDTH] = w_xor[other*DATA_WIDTH+:DATA_WIDTH]
+                        ^ w_bank_read[(other*BANKS+WRITE_PORTS-1+port)*DATA_WIDTH+:DATA_WIDTH];
+                end
+                reg [DATA_WIDTH-1:0] r_read = 0;
+                always @( posedge clk ) r_read <= w_xor[WRITE_PORTS*DATA_WIDTH+:DATA_WIDTH];
+                assign read_data[port*DATA_WIDTH+:DATA_WIDTH] = r_read;
+            end
+        end else begin
+            // live value table, 1 register row written by every port. The read is a mux tree in MEM_LATENCY
+            // registered stages next to the banks, each resolves LVT_STEP address bits, low bits first
+            localparam TABLE_WIDTH  = ( 1 << ADDRESS_WIDTH ) * LVT_WIDTH;
+            localparam LVT_STEP     = ( ADDRESS_WIDTH + MEM_LATENCY - 1 ) / MEM_LATENCY;
+            reg [TABLE_WIDTH-1:0] r_lvt = 0;
+            integer idx;
+            always @( posedge clk ) begin
+                for( idx = 0; idx < WRITE_PORTS; idx = idx + 1 )
+                    if( w_write_enable[idx] )
+                        r_lvt[write_address[idx*ADDRESS_WIDTH+:ADDRESS_WIDTH]*LVT_WIDTH+:LVT_WIDTH] <= idx;
+            end
+
+            for( port = 0; port < READ_PORTS; port = port + 1 ) begin : lvt_read_loop
+                // stage 0 is the table and the read address, a stage keeps the entries left after its
+                // address bits, entry n at n * LVT_WIDTH, the last stage keeps the select
+                wire [(MEM_LATENCY+1)*TABLE_WIDTH-1:0]      w_stage;
+                wire [(MEM_LATENCY+1)*ADDRESS_WIDTH-1:0]    w_stage_address;
+                wire [LVT_WIDTH-1:0]                        w_select;
+                wire [WRITE_PORTS*DATA_WIDTH-1:0]           w_bank_read;
+                assign w_stage[TABLE_WIDTH-1:0]             = r_lvt;
+                assign w_stage_address[ADDRESS_WIDTH-1:0]   = read_address[port*ADDRESS_WIDTH+:ADDRESS_WIDTH];
+                for( stage = 0; stage < MEM_LATENCY; stage = stage + 1 ) begin : lvt_stage_loop
+                    localparam LOW      = stage * LVT_STEP < ADDRESS_WIDTH ? stage * LVT_STEP : ADDRESS_WIDTH;
+                    localparam HIGH     = ( stage + 1 ) * LVT_STEP < ADDRESS_WIDTH ? ( stage + 1 ) * LVT_STEP : ADDRESS_WIDTH;
+                    localparam ENTRIES  = 1 << ( ADDRESS_WIDTH - HIGH );
+                    wire [TABLE_WIDTH-1:0]      w_entries   = w_stage[stage*TABLE_WIDTH+:TABLE_WIDTH];
+                    wire [ADDRESS_WIDTH-1:0]    w_address   = w_stage_address[stage*ADDRESS_WIDTH+:ADDRESS_WIDTH];
+                    wire [ADDRESS_WIDTH-1:0]    w_bits      = ( w_address >> LOW ) & ( ( 1 << ( HIGH - LOW ) ) - 1 );
+                    reg  [TABLE_WIDTH-1:0]      r_entries   = 0;
+                    reg  [ADDRESS_WIDTH-1:0]    r_address   = 0;
+                    integer entry;
+                    always @( posedge clk ) begin
+                        for( entry = 0; entry < ENTRIES; entry = entry + 1 )
+                            r_entries[entry*LVT_WIDTH+:LVT_WIDTH] <= w_entries[( ( entry << ( HIGH - LOW ) ) + w_bits )*LVT_WIDTH+:LVT_WIDTH];
+                        r_address <= w_address;
+                    end
+                    assign w_stage[(stage+1)*TABLE_WIDTH+:TABLE_WIDTH]             = r_entries;
+                    assign w_stage_address[(stage+1)*ADDRESS_WIDTH+:ADDRESS_WIDTH] = r_address;
+                end
+                assign w_select = w_stage[MEM_LATENCY*TABLE_WIDTH+:LVT_WIDTH];
+                for( bank = 0; bank < WRITE_PORTS; bank = bank + 1 ) begin : lvt_bank_loop
+                    memory_pipelined
+                        #(
+                            .DATA_WIDTH(    DATA_WIDTH ),
+                            .DEPTH(         DEPTH ),
+                            .ADDRESS_WIDTH( ADDRESS_WIDTH ),
+                            .LATENCY(       MEM_LATENCY ),
+                            .STYLE(         STYLE )
+                        )
+                        lvt_bank
+                        (
+                            .clk(           clk ),
+                            .write_enable(  w_write_enable[bank] ),
+                            .write_address( write_address[bank*ADDRESS_WIDTH+:ADDRESS_WIDTH] ),
+                            .write_data(    write_data[bank*DATA_WIDTH+:DATA_WIDTH] ),
+                            .read_address(  read_address[port*ADDRESS_WIDTH+:ADDRESS_WIDTH] ),
+                            .read_data(     w_bank_read[bank*DATA_WIDTH+:DATA_WIDTH] )
+                        );
+                end
+                reg [DATA_WIDTH-1:0] r_read = 0;
+                always @( posedge clk ) r_read <= w_bank_read[w_select*DATA_WIDTH+:DATA_WIDTH];
+                assign read_data[port*DATA_WIDTH+:DATA_WIDTH] = r_read;
+            end
+        end
+    endgenerate
+endmodule
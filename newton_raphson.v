@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	newton_raphson.v
+//
+// Project:	newton raphson
+//
+// Purpose:	Pipelined reciprocal and reciprocal square root using a seed
+//          table and unrolled newton raphson iterations. 1 result per clock.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// newton_raphson - result = 1 / x or 1 / sqrt( x )
+//  I1 is unsigned with 1 integer bit and MUST BE normalized, x = I1 / 2**(WIDTH-1), 1 <= x < 2
+//  result has the same format, 0.5 < result <= 1. The caller shifts the exponent.
+//  FUNCTION
+//      "RECIPROCAL"    y = y * ( 2 - x * y )                   2 multiplies per iteration
+//      "RSQRT"         y = y * ( 3 - x * y * y ) / 2           3 multiplies per iteration
+//
+// The top 'SEED_BITS' of the fraction select a seed from a block rom, f() of the middle of the
+// interval, generated at elaboration time. Each iteration roughly doubles the correct bits.
+// The iterations are unrolled, the multiplies are 'math_pipelined_multiply' and the subtracts
+// are 'math_pipelined_add' with an inverted operand. The iterations run with 'GUARD_BITS' extra
+// fraction bits that are rounded off at the end. Both iterations converge from below, the result
+// never passes 1.0.
+// result is valid LATENCY = 1 + ITERATIONS * ITERATION_LATENCY + ADD_LATENCY clocks after I1.
+//  ITERATION_LATENCY = 2 * MULT_LATENCY + ADD_LATENCY for RECIPROCAL, 3 * MULT_LATENCY + ADD_LATENCY for RSQRT
+//
+// Maximum error in result ulps, every normalized input tested against f() in real arithmetic. The
+// second row is the default parameters, newton_raphson_tb.v with a row's parameters reports its entries.
+//  WIDTH SEED_BITS ITERATIONS GUARD_BITS   RECIPROCAL  RSQRT
+//  16    7         1          3            0.97        0.61
+//  18    8         1          4            0.98        0.65
+//  18    6         2          4            0.56        0.56
+//  24    12        1          4            0.62        0.56
+//  24    7         2          4            0.56        0.56
+module newton_raphson
+    #(
+        parameter FUNCTION      = "RECIPROCAL",
+        parameter WIDTH         = 18,
+        parameter SEED_BITS     = 8,
+        parameter ITERATIONS    = 1,
+        parameter GUARD_BITS    = 4,
+        parameter MULT_LATENCY  = 2,
+        parameter ADD_LATENCY   = 1,
+        parameter DSP           = 1
+    )
+    (
+        input   wire                clk,
+        input   wire    [WIDTH-1:0] I1,
+        output  wire    [WIDTH-1:0] result
+    );
+    localparam FRAC                 = WIDTH - 1 + GUARD_BITS;   // fraction bits of 'y'
+    localparam ITERATION_LATENCY    = ( FUNCTION == "RSQRT" ? 3 : 2 ) * MULT_LATENCY + ADD_LATENCY;
+    localparam LATENCY              = 1 + ITERATIONS * ITERATION_LATENCY + ADD_LATENCY;
+
+    // f_Seed - Returns the seed for the middle of the interval, with FRAC fraction bits
+    function integer f_Seed;
+        input integer index;
+        real x;
+        begin
+            x = 1.0 + ( index + 0.5 ) / $pow( 2.0, SEED_BITS );
+            if( FUNCTION == "RSQRT" )
+                x = 1.0 / $sqrt( x );
+            else
+                x = 1.0 / x;
+            f_Seed = $rtoi( x * $pow( 2.0, FRAC ) + 0.5 );
+        end
+    endfunction
+
+    // seed rom
+    (* syn_romstyle = "block_rom" *) reg [FRAC:0] r_rom [0:(1<<SEED_BITS)-1];
+    integer index;
+    initial for( index = 0; index < (1<<SEED_BITS); index = index + 1 ) r_rom[index] = f_Seed( index );
+    reg [FRAC:0]        r_seed  = 0;
+    reg [WIDTH-1:0]     r_x     = 0;
+    always @( posedge clk ) begin
+        r_seed  <= r_rom[I1[WIDTH-2-:SEED_BITS]];
+        r_x     <= I1;
+    end
+
+    // y[0] is the seed
+    wire [(ITERATIONS+1)*(FRAC+1)-1:0] w_y;
+    assign w_y[FRAC:0] = r_seed;
+    genvar iteration;
+    generate
+        for( iteration = 0; iteration < ITERATIONS; iteration = iteration + 1 ) begin : nr_iteration_loop
+            wire [FRAC:0]           w_y_in = w_y[iteration*(FRAC+1)+:FRAC+1];
+            wire [WIDTH-1:0]        w_x;
+            wire [WIDTH+FRAC:0]     w_xy;
+            wire [FRAC+1:0]         w_error;    // 2 - x*y or 3 - x*y*y
+            wire [FRAC:0]           w_y_error;  // y lined up with w_error
+            wire [2*FRAC+2:0]       w_y_next;
+            ff_delay #( .WIDTH( WIDTH ), .DEPTH( iteration * ITERATION_LATENCY ) ) x_delay ( .clk( clk ), .D( r_x ), .Q( w_x ) );
+            math_pipelined_multiply #( .WIDTH_A( WIDTH ), .WIDTH_B( FRAC + 1 ), .LATENCY( MULT_LATENCY ), .SIGNED( 0 ), .DSP( DSP ) ) xy_multiply
+                ( .clk( clk ), .I1( w_x ), .I2( w_y_in ), .product( w_xy ) );
+            if( FUNCTION == "RSQRT" ) begin
+                wire [FRAC:0]       w_y_xy;
+                wire [2*FRAC+2:0]   w_xyy;
+                ff_delay #( .WIDTH( FRAC + 1 ), .DEPTH( MULT_LATENCY ) ) y_xy_delay ( .clk( clk ), .D( w_y_in ), .Q( w_y_xy ) );
+                math_pipelined_multiply #( .WIDTH_A( FRAC + 2 ), .WIDTH_B( FRAC + 1 ), .LATENCY( MULT_LATENCY ), .SIGNED( 0 ), .DSP( DSP ) ) xyy_multiply
+                    ( .clk( clk ), .I1( w_xy[WIDTH-1+:FRAC+2] ), .I2( w_y_xy ), .product( w_xyy ) );
+                math_pipelined_add #( .WIDTH( FRAC + 2 ), .LATENCY( ADD_LATENCY ) ) error_add
+                    ( .clk( clk ), .I1( { 2'b11, {FRAC{1'b0}} } ), .I2( ~w_xyy[FRAC+:FRAC+2] ), .cin( 1'b1 ), .sum( w_error ), .cout() );
+                ff_delay #( .WIDTH( FRAC + 1 ), .DEPTH( 2 * MULT_LATENCY + ADD_LATENCY ) ) y_error_delay ( .clk( clk ), .D( w_y_in ), .Q( w_y_error ) );
+                math_pipelined_multiply #( .WIDTH_A( FRAC + 1 ), .WIDTH_B( FRAC + 2 ), .LATENCY( MULT_LATENCY ), .SIGNED( 0 ), .DSP( DSP ) ) y_multiply
+                    ( .clk( clk ), .I1( w_y_error ), .I2( w_error ), .product( w_y_next ) );
+                // divide by 2
+                assign w_y[(iteration+1)*(FRAC+1)+:FRAC+1] = w_y_next[FRAC+1+:FRAC+1];
+            end else begin
+                math_pipelined_add #( .WIDTH( FRAC + 2 ), .LATENCY( ADD_LATENCY ) ) error_add
+                    ( .clk( clk ), .I1( { 2'b10, {FRAC{1'b0}} } ), .I2( ~w_xy[WIDTH-1+:FRAC+2] ), .cin( 1'b1 ), .sum( w_error ), .cout() );
+                ff_delay #( .WIDTH( FRAC + 1 ), .DEPTH( MULT_LATENCY + ADD_LATENCY ) ) y_error_delay ( .clk( clk ), .D( w_y_in ), .Q( w_y_error ) );
+                math_pipelined_multiply #( .WIDTH_A( FRAC + 1 ), .WIDTH_B( FRAC + 2 ), .LATENCY( MULT_LATENCY ), .SIGNED( 0 ), .DSP( DSP ) ) y_multiply
+                    ( .clk( clk ), .I1( w_y_error ), .I2( w_error ), .product( w_y_next ) );
+                assign w_y[(iteration+1)*(FRAC+1)+:FRAC+1] = w_y_next[FRAC+:FRAC+1];
+            end
+        end
+    endgenerate
+
+    // round off the guard bits
+    wire [FRAC+1:0] w_rounded;
+    math_pipelined_add #( .WIDTH( FRAC + 2 ), .LATENCY( ADD_LATENCY ) ) round_add
+    (
+        .clk(   clk ),
+        .I1(    { 1'b0, w_y[ITERATIONS*(FRAC+1)+:FRAC+1] } ),
+        .I2(    GUARD_BITS > 0 ? 1 << ( GUARD_BITS - 1 ) : 0 ),
+        .cin(   1'b0 ),
+        .sum(   w_rounded ),
+        .cout()
+    );
+    assign result = w_rounded[GUARD_BITS+:WIDTH];
+endmodule
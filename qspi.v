@@ -0,0 +1,431 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	qspi.v
+//
+// Project:	qspi master
+//
+// Purpose:	Single / dual / quad SPI flash master with command, transmit and
+//          receive fifos and an execute in place read port.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// qspi_master - SPI mode 0 flash master, spi_sck = clk / ( 2 * divider ), divider 1 is clk / 2
+//  A command is up to 5 phases, each skipped when its lanes are 0 ( 0 none, 1 single, 2 dual, 3 quad ):
+//      instruction     8 bits on cmd_instruction_lanes
+//      address         24 bits, 32 when cmd_address_4byte, on cmd_address_lanes
+//      alternate       8 bits when cmd_alt_enable, on cmd_address_lanes
+//      dummy           cmd_dummy clocks with the lanes released
+//      data            cmd_length + 1 bytes on cmd_data_lanes, from tx when cmd_write or to rx
+//  The instruction and dummy phases are single data rate. With cmd_ddr the address, alternate and data
+//  phases move a beat on both edges of spi_sck, and must be whole spi_sck clocks, the outputs change
+//  on the edges so the board or the output delay has to centre them for the flash.
+//  Commands are queued in a command fifo, tx and rx are fifos of bytes. spi_sck stops while tx is empty
+//  or rx is full, so bursts of any length run at the full rate as long as the fifos keep up.
+//  xip - memory reads of 32 bit words, xip_address is the byte address of the word, the word is
+//  little endian in xip_rdata when xip_rvalid is set. The first read sends the XIP_* command, reads
+//  of the next word continue the same data phase without a new command. Between reads spi_sck stops
+//  with spi_cs_n low, a queued command or a read of another address ends the burst.
+//  spi_cs_n stays high for CS_HIGH_TICKS half spi_sck clocks between commands. spi_io_out[3:2] drive
+//  WP# and HOLD# high unless the command uses quad lanes.
+//
+//  The half spi_sck clock is a counter_with_strobe, the strobe is an edge of spi_sck. Single data rate
+//  phases drive on the falling edge and sample on the rising edge, double data rate phases do both on
+//  every edge.
+module qspi_master
+    #(
+        parameter DIVIDER_WIDTH         = 8,
+        parameter LENGTH_WIDTH          = 16,
+        parameter FIFO_ADDRESS_WIDTH    = 4,
+        parameter CS_HIGH_TICKS         = 4,
+        parameter XIP_INSTRUCTION       = 8'hEB,
+        parameter XIP_INSTRUCTION_LANES = 1,
+        parameter XIP_ADDRESS_LANES     = 3,
+        parameter XIP_ADDRESS_4BYTE     = 0,
+        parameter XIP_ALT_ENABLE        = 1,
+        parameter XIP_ALT               = 8'hFF,
+        parameter XIP_DUMMY             = 4,
+        parameter XIP_DATA_LANES        = 3
+    )
+    (
+        input   wire                        clk,
+        input   wire                        rst,
+        input   wire [DIVIDER_WIDTH-1:0]    divider,
+        output  wire                        busy,
+        // command
+        input   wire                        cmd_valid,
+        output  wire                        cmd_ready,
+        input   wire [7:0]                  cmd_instruction,
+        input   wire [1:0]                  cmd_instruction_lanes,
+        input   wire [31:0]                 cmd_address,
+        input   wire [1:0]                  cmd_address_lanes,
+        input   wire                        cmd_address_4byte,
+        input   wire                        cmd_alt_enable,
+        input   wire [7:0]                  cmd_alt,
+        input   wire [4:0]                  cmd_dummy,
+        input   wire [1:0]                  cmd_data_lanes,
+        input   wire                        cmd_write,
+        input   wire [LENGTH_WIDTH-1:0]     cmd_length,
+        input   wire                        cmd_ddr,
+        // data
+        input   wire                        tx_valid,
+        output  wire                        tx_ready,
+        input   wire [7:0]                  tx_data,
+        output  wire                        rx_valid,
+        input   wire                        rx_ready,
+        output  wire [7:0]                  rx_data,
+        // execute in place
+        input   wire                        xip_valid,
+        output  wire                        xip_ready,
+        input   wire [31:0]                 xip_address,
+        output  wire                        xip_rvalid,
+        output  wire [31:0]                 xip_rdata,
+        // flash
+        output  wire                        spi_sck,
+        output  wire                        spi_cs_n,
+        output  wire [3:0]                  spi_io_out,
+        output  wire [3:0]                  spi_io_oe,
+        input   wire [3:0]                  spi_io_in
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    localparam STOP_WIDTH = f_Log2( CS_HIGH_TICKS + 1 );
+    localparam CMD_WIDTH  = 8 + 2 + 32 + 2 + 1 + 1 + 8 + 5 + 2 + 1 + LENGTH_WIDTH + 1;
+
+    localparam STATE_IDLE  = 0;
+    localparam STATE_LOAD  = 1;
+    localparam STATE_SHIFT = 2;
+    localparam STATE_STOP  = 3;
+
+    localparam PHASE_INSTRUCTION = 0;
+    localparam PHASE_ADDRESS     = 1;
+    localparam PHASE_ALT         = 2;
+    localparam PHASE_DUMMY       = 3;
+    localparam PHASE_DATA        = 4;
+    localparam PHASE_DONE        = 5;
+    localparam PHASE_START       = 7;
+
+    // the first phase after 'phase' that is present
+    function [2:0] f_NextPhase;
+        input [2:0] phase;
+        input [4:0] present;
+        integer idx;
+        begin
+            f_NextPhase = PHASE_DONE;
+            for( idx = 4; idx >= 0; idx = idx - 1 )
+                if( present[idx] && ( phase == PHASE_START || idx > phase ) )
+                    f_NextPhase = idx;
+        end
+    endfunction
+
+    // fifos
+    wire                    w_cmd_valid;
+    wire                    w_cmd_pop;
+    wire [CMD_WIDTH-1:0]    w_cmd;
+    fifo_sync #( .WIDTH( CMD_WIDTH ), .ADDRESS_WIDTH( FIFO_ADDRESS_WIDTH ) ) cmd_fifo
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  cmd_valid ),
+        .in_ready(  cmd_ready ),
+        .in_data(   { cmd_instruction, cmd_instruction_lanes, cmd_address, cmd_address_lanes, cmd_address_4byte, cmd_alt_enable, cmd_alt, cmd_dummy, cmd_data_lanes, cmd_write, cmd_length, cmd_ddr } ),
+        .out_valid( w_cmd_valid ),
+        .out_ready( w_cmd_pop ),
+        .out_data(  w_cmd ),
+        .count()
+    );
+    wire                    w_tx_valid;
+    wire                    w_tx_pop;
+    wire [7:0]              w_tx_data;
+    fifo_sync #( .WIDTH( 8 ), .ADDRESS_WIDTH( FIFO_ADDRESS_WIDTH ) ) tx_fifo
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  tx_valid ),
+        .in_ready(  tx_ready ),
+        .in_data(   tx_data ),
+        .out_valid( w_tx_valid ),
+        .out_ready( w_tx_pop ),
+        .out_data(  w_tx_data ),
+        .count()
+    );
+    wire                    w_rx_push;
+    wire                    w_rx_ready;
+    wire [31:0]             w_in_next;
+    fifo_sync #( .WIDTH( 8 ), .ADDRESS_WIDTH( FIFO_ADDRESS_WIDTH ) ) rx_fifo
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  w_rx_push ),
+        .in_ready(  w_rx_ready ),
+        .in_data(   w_in_next[7:0] ),
+        .out_valid( rx_valid ),
+        .out_ready( rx_ready ),
+        .out_data(  rx_data ),
+        .count()
+    );
+
+    // the command in flight
+    reg  [1:0]              r_state             = STATE_IDLE;
+    reg                     r_xip               = 0;
+    reg  [7:0]              r_instruction       = 0;
+    reg  [1:0]              r_instruction_lanes = 0;
+    reg  [31:0]             r_address           = 0;
+    reg  [1:0]              r_address_lanes     = 0;
+    reg                     r_address_4byte     = 0;
+    reg                     r_alt_enable        = 0;
+    reg  [7:0]              r_alt               = 0;
+    reg  [4:0]              r_dummy             = 0;
+    reg  [1:0]              r_data_lanes        = 0;
+    reg                     r_write             = 0;
+    reg  [LENGTH_WIDTH-1:0] r_length            = 0;
+    reg                     r_ddr               = 0;
+    wire [4:0]              w_present           = { r_data_lanes != 2'd0, r_dummy != 5'd0, r_alt_enable && r_address_lanes != 2'd0, r_address_lanes != 2'd0, r_instruction_lanes != 2'd0 };
+    wire                    w_quad              = r_instruction_lanes == 2'd3 || r_address_lanes == 2'd3 || r_data_lanes == 2'd3;
+
+    // the phase in flight
+    reg  [2:0]              r_phase             = PHASE_START;
+    reg  [1:0]              r_lanes             = 0;
+    reg                     r_ddr_phase         = 0;
+    reg                     r_drive             = 0;
+    reg  [4:0]              r_beats             = 0;    // beats left in the phase - 1, not data
+    reg  [LENGTH_WIDTH-1:0] r_bytes             = 0;    // bytes left in the data phase - 1
+    reg  [2:0]              r_out_bits          = 0;
+    reg  [4:0]              r_in_bits           = 0;
+    reg  [31:0]             r_out               = 0;    // msb first
+    reg  [31:0]             r_in                = 0;
+    reg                     r_sck               = 0;
+    reg                     r_cs_n              = 1;
+    reg  [STOP_WIDTH-1:0]   r_stop_ticks        = 0;
+    reg  [31:0]             r_xip_next          = 0;
+    reg                     r_word_done         = 0;
+    reg                     r_xip_rvalid        = 0;
+    reg  [31:0]             r_xip_rdata         = 0;
+    wire [2:0]              w_next_phase        = f_NextPhase( r_phase, w_present );
+
+    // bits per beat
+    wire [2:0]              w_step              = { r_lanes == 2'd3, r_lanes == 2'd2, r_lanes == 2'd1 };
+    wire [2:0]              w_out_bits_next     = r_out_bits + w_step;
+    wire [4:0]              w_in_bits_next      = r_in_bits + w_step;
+    wire                    w_byte_out          = w_out_bits_next == 3'd0;
+    wire                    w_byte_in           = w_in_bits_next[2:0] == 3'd0;
+    wire                    w_word_in           = w_in_bits_next == 5'd0;
+    reg  [31:0]             w_out_shifted;
+    reg  [31:0]             w_in_shifted;
+    always @(*) begin
+        case( r_lanes )
+            2'd3:       begin w_out_shifted = { r_out[27:0], 4'd0 }; w_in_shifted = { r_in[27:0], spi_io_in[3:0] }; end
+            2'd2:       begin w_out_shifted = { r_out[29:0], 2'd0 }; w_in_shifted = { r_in[29:0], spi_io_in[1:0] }; end
+            default:    begin w_out_shifted = { r_out[30:0], 1'b0 }; w_in_shifted = { r_in[30:0], spi_io_in[1] }; end
+        endcase
+    end
+    assign w_in_next = w_in_shifted;
+
+    // the first beat of the next phase
+    reg  [1:0]              w_enter_lanes;
+    reg                     w_enter_ddr;
+    reg                     w_enter_drive;
+    reg  [31:0]             w_enter_out;
+    reg  [4:0]              w_enter_beats;
+    always @(*) begin
+        w_enter_lanes   = r_data_lanes;
+        w_enter_ddr     = 1'b0;
+        w_enter_drive   = 1'b0;
+        w_enter_out     = { w_tx_data, 24'd0 };
+        w_enter_beats   = r_dummy - 1'b1;
+        case( w_next_phase )
+            PHASE_INSTRUCTION: begin
+                w_enter_lanes   = r_instruction_lanes;
+                w_enter_drive   = 1'b1;
+                w_enter_out     = { r_instruction, 24'd0 };
+                w_enter_beats   = ( 6'd8 >> ( r_instruction_lanes - 1'b1 ) ) - 1'b1;
+            end
+            PHASE_ADDRESS: begin
+                w_enter_lanes   = r_address_lanes;
+                w_enter_ddr     = r_ddr;
+                w_enter_drive   = 1'b1;
+                w_enter_out     = r_address_4byte ? r_address : { r_address[23:0], 8'd0 };
+                w_enter_beats   = ( ( r_address_4byte ? 6'd32 : 6'd24 ) >> ( r_address_lanes - 1'b1 ) ) - 1'b1;
+            end
+            PHASE_ALT: begin
+                w_enter_lanes   = r_address_lanes;
+                w_enter_ddr     = r_ddr;
+                w_enter_drive   = 1'b1;
+                w_enter_out     = { r_alt, 24'd0 };
+                w_enter_beats   = ( 6'd8 >> ( r_address_lanes - 1'b1 ) ) - 1'b1;
+            end
+            PHASE_DATA: begin
+                w_enter_ddr     = r_ddr;
+                w_enter_drive   = r_write;
+            end
+        endcase
+    end
+
+    // edges, a strobe is the next edge of spi_sck
+    wire                    w_strobe;
+    wire                    w_running           = r_state == STATE_SHIFT || r_state == STATE_STOP;
+    wire                    w_sample            = r_state == STATE_SHIFT && ( r_ddr_phase || !r_sck );
+    wire                    w_advance           = r_state == STATE_SHIFT && ( r_ddr_phase ||  r_sck );
+    wire                    w_data              = r_phase == PHASE_DATA;
+    wire                    w_reading           = w_data && !r_write;
+    wire                    w_phase_last        = w_data ? w_byte_out && r_bytes == 0 && !r_xip : r_beats == 0;
+    wire                    w_need_tx           = w_phase_last ? w_next_phase == PHASE_DATA && r_write : w_data && r_write && w_byte_out;
+    wire                    w_xip_boundary      = r_xip && r_word_done;
+    wire                    w_xip_end           = w_cmd_valid || ( xip_valid && xip_address != r_xip_next );
+    wire                    w_xip_continue      = xip_valid && !w_xip_end;
+    wire                    w_stall             = ( w_advance && ( ( w_need_tx && !w_tx_valid ) || ( w_xip_boundary && !w_xip_end && !xip_valid ) ) )
+                                               || ( w_sample && w_reading && !r_xip && w_byte_in && !w_rx_ready );
+    wire                    w_tick              = w_strobe && !w_stall;
+    wire                    w_end               = w_tick && w_advance && ( ( w_xip_boundary && w_xip_end ) || ( w_phase_last && w_next_phase == PHASE_DONE ) );
+    wire                    w_enter             = r_state == STATE_LOAD ? !( w_next_phase == PHASE_DATA && r_write && !w_tx_valid ) : w_tick && w_advance && w_phase_last && !w_end;
+
+    counter_with_strobe #( .WIDTH( DIVIDER_WIDTH ), .LATENCY( 0 ) ) sck_divider
+    (
+        .rst(           rst || !w_running ),
+        .clk(           clk ),
+        .enable(        w_running ),
+        .reset_value(   divider ),
+        .strobe(        w_strobe ),
+        .ready(),
+        .valid()
+    );
+
+    assign w_cmd_pop    = r_state == STATE_IDLE;
+    assign w_tx_pop     = w_tx_valid && ( ( w_enter && w_next_phase == PHASE_DATA && r_write ) || ( w_tick && w_advance && w_need_tx && !w_phase_last ) );
+    assign w_rx_push    = w_tick && w_sample && w_reading && !r_xip && w_byte_in;
+    assign xip_ready    = ( r_state == STATE_IDLE && !w_cmd_valid ) || ( w_tick && w_advance && w_xip_boundary && w_xip_continue );
+    assign xip_rvalid   = r_xip_rvalid;
+    assign xip_rdata    = r_xip_rdata;
+    assign busy         = r_state != STATE_IDLE || w_cmd_valid;
+
+    assign spi_sck      = r_sck;
+    assign spi_cs_n     = r_cs_n;
+    assign spi_io_out   = r_drive && r_lanes == 2'd3 ? r_out[31:28] : r_lanes == 2'd2 ? { 2'b11, r_out[31:30] } : { 3'b110, r_out[31] };
+    assign spi_io_oe    = { ( w_quad && !r_cs_n ) ? { 2{ r_drive && r_lanes == 2'd3 } } : 2'b11, r_drive && r_lanes[1], r_drive };
+
+    always @( posedge clk ) begin
+        r_xip_rvalid <= 1'b0;
+        case( r_state )
+            STATE_IDLE: begin
+                r_phase <= PHASE_START;
+                if( w_cmd_valid ) begin
+                    { r_instruction, r_instruction_lanes, r_address, r_address_lanes, r_address_4byte, r_alt_enable, r_alt, r_dummy, r_data_lanes, r_write, r_length, r_ddr } <= w_cmd;
+                    r_xip   <= 1'b0;
+                    r_state <= STATE_LOAD;
+                end else if( xip_valid ) begin
+                    r_instruction       <= XIP_INSTRUCTION;
+                    r_instruction_lanes <= XIP_INSTRUCTION_LANES;
+                    r_address           <= xip_address;
+                    r_address_lanes     <= XIP_ADDRESS_LANES;
+                    r_address_4byte     <= XIP_ADDRESS_4BYTE;
+                    r_alt_enable        <= XIP_ALT_ENABLE;
+                    r_alt               <= XIP_ALT;
+                    r_dummy             <= XIP_DUMMY;
+                    r_data_lanes        <= XIP_DATA_LANES;
+                    r_write             <= 1'b0;
+                    r_ddr               <= 1'b0;
+                    r_xip               <= 1'b1;
+                    r_xip_next          <= xip_address + 3'd4;
+                    r_state             <= STATE_LOAD;
+                end
+            end
+            STATE_LOAD: begin
+                r_cs_n      <= 1'b0;
+                r_sck       <= 1'b0;
+                r_word_done <= 1'b0;
+                if( w_enter )
+                    r_state <= w_next_phase == PHASE_DONE ? STATE_STOP : STATE_SHIFT;
+            end
+            STATE_SHIFT: begin
+                if( w_tick ) begin
+                    r_sck <= !r_sck;
+                    if( w_sample && w_reading ) begin
+                        r_in        <= w_in_next;
+                        r_in_bits   <= w_in_bits_next;
+                        if( r_xip && w_word_in ) begin
+                            r_word_done     <= 1'b1;
+                            r_xip_rvalid    <= 1'b1;
+                            r_xip_rdata     <= { w_in_next[7:0], w_in_next[15:8], w_in_next[23:16], w_in_next[31:24] };
+                        end
+                    end
+                    if( w_advance ) begin
+                        if( w_xip_boundary ) begin
+                            r_word_done <= 1'b0;
+                            r_xip_next  <= r_xip_next + 3'd4;
+                        end
+                        if( !w_phase_last ) begin
+                            r_beats <= r_beats - 1'b1;
+                            r_out   <= w_out_shifted;
+                            if( w_data ) begin
+                                r_out_bits <= w_out_bits_next;
+                                if( w_byte_out ) begin
+                                    r_bytes <= r_bytes - 1'b1;
+                                    if( r_write )
+                                        r_out <= { w_tx_data, 24'd0 };
+                                end
+                            end
+                        end
+                    end
+                    if( w_end ) begin
+                        r_sck   <= 1'b0;
+                        r_cs_n  <= 1'b1;
+                        r_drive <= 1'b0;
+                        r_state <= STATE_STOP;
+                    end
+                end
+            end
+            STATE_STOP: begin
+                r_cs_n <= 1'b1;
+                if( w_tick ) begin
+                    r_stop_ticks <= r_stop_ticks + 1'b1;
+                    if( r_stop_ticks == CS_HIGH_TICKS - 1 )
+                        r_state <= STATE_IDLE;
+                end
+            end
+        endcase
+        if( r_state != STATE_STOP )
+            r_stop_ticks <= 'd0;
+        if( w_enter ) begin
+            r_phase     <= w_next_phase;
+            r_lanes     <= w_enter_lanes;
+            r_ddr_phase <= w_enter_ddr;
+            r_drive     <= w_enter_drive;
+            r_out       <= w_enter_out;
+            r_beats     <= w_enter_beats;
+            r_bytes     <= r_length;
+            r_out_bits  <= 3'd0;
+            r_in_bits   <= 5'd0;
+        end
+        if( rst ) begin
+            r_state         <= STATE_IDLE;
+            r_phase         <= PHASE_START;
+            r_sck           <= 1'b0;
+            r_cs_n          <= 1'b1;
+            r_drive         <= 1'b0;
+            r_word_done     <= 1'b0;
+            r_xip_rvalid    <= 1'b0;
+        end
+    end
+endmodule
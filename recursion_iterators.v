@@ -335,3 +335,16 @@ function automatic integer iterator_NaryRecursionGetUnitInputAddress;
     `undef units_on_this_depth
 endfunction
 //    initial begin:test_NaryRecursionGetUnitInputAddress integer unit_index,input_index;$display("f_NaryRecursionGetUnitInputAddress");for(unit_index=0;unit_index<=3;unit_index=unit_index+1)for( input_index=0;input_index<4;input_index=input_index+1)$display("unit:%d input:%d address:%d width:%d",unit_index,input_index,f_NaryRecursionGetUnitInputAddress(10,4,unit_index,input_index), f_NaryRecursionGetUnitWidth(10, 4, unit_index));end
+
+//
+    ///////////////////////////////////////////
+    // Sizing Functions                      //
+    // f_Log2                                //
+    ///////////////////////////////////////////
+
+//  f_Log2 - Returns the bits needed to address 'depth' entries, minimum 1
+//  depth       - Number of entries, f_Log2( N + 1 ) is the width of a count from 0 to N
+function automatic integer f_Log2;
+    input integer depth;
+    for( f_Log2 = 1; ( 1 << f_Log2 ) < depth; f_Log2 = f_Log2 + 1 ) ;
+endfunction
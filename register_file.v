@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	register_file.v
+//
+// Project:	register file
+//
+// Purpose:	Multi port register file whose reads see the writes of the same
+//          clock and every write still in flight, through bypass forwarding.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// register_file - 'multiport_memory' with write to read bypass
+//  The ports are the same as 'multiport_memory'. A read returns the value written by the last write
+//  to its address up to and including the clock of the read, so a pipeline can read a register on
+//  the clock it is written. read_data is valid exactly LATENCY = MEM_LATENCY + 2 clocks after
+//  read_address, the memory takes MEM_LATENCY + 1 and the bypass select 1.
+//  The memory does not see a write for WINDOW clocks, 1 for "LVT" and MEM_LATENCY + 1 for "XOR". The
+//  writes of the last WINDOW clocks are kept, and every read compares its address with each of them
+//  in an N-ary math_pipelined_reduce "AND" tree over { valid, ~( read address ^ write address ) },
+//  the 'cmp_eq' tree of math_pipelined, that takes COMPARE_LATENCY clocks. The newest match, the
+//  highest port on the same clock, replaces the memory's word.
+//  COMPARE_LATENCY <= MEM_LATENCY + 1
+module register_file
+    #(
+        parameter WRITE_PORTS       = 1,
+        parameter READ_PORTS        = 2,
+        parameter DATA_WIDTH        = 32,
+        parameter DEPTH             = 32,
+        parameter ADDRESS_WIDTH     = 5,
+        parameter SCHEME            = "LVT",
+        parameter MEM_LATENCY       = 1,
+        parameter STYLE             = "distributed_ram",
+        parameter COMPARE_LATENCY   = 1
+    )
+    (
+        input   wire                                    clk,
+        input   wire    [WRITE_PORTS-1:0]               write_enable,
+        input   wire    [WRITE_PORTS*ADDRESS_WIDTH-1:0] write_address,
+        input   wire    [WRITE_PORTS*DATA_WIDTH-1:0]    write_data,
+        input   wire    [READ_PORTS*ADDRESS_WIDTH-1:0]  read_address,
+        output  wire    [READ_PORTS*DATA_WIDTH-1:0]     read_data
+    );
+    localparam WINDOW       = SCHEME == "XOR" ? MEM_LATENCY + 1 : 1;
+    localparam SLOTS        = WINDOW * WRITE_PORTS;     // slot age * WRITE_PORTS + port, age 0 is this clock
+    localparam READ_LATENCY = MEM_LATENCY + 1;
+
+    wire [READ_PORTS*DATA_WIDTH-1:0] w_memory_read;
+    multiport_memory
+        #(
+            .WRITE_PORTS(   WRITE_PORTS ),
+            .READ_PORTS(    READ_PORTS ),
+            .DATA_WIDTH(    DATA_WIDTH ),
+            .DEPTH(         DEPTH ),
+            .ADDRESS_WIDTH( ADDRESS_WIDTH ),
+            .SCHEME(        SCHEME ),
+            .MEM_LATENCY(   MEM_LATENCY ),
+            .STYLE(         STYLE )
+        )
+        memory
+        (
+            .clk(           clk ),
+            .write_enable(  write_enable ),
+            .write_address( write_address ),
+            .write_data(    write_data ),
+            .read_address(  read_address ),
+            .read_data(     w_memory_read )
+        );
+
+    // the writes the memory does not see yet, this clock's and the last WINDOW - 1 clocks', the
+    // history keeps WINDOW clocks so it is never empty, the oldest is not used
+    reg  [SLOTS-1:0]                r_history_valid     = 0;
+    reg  [SLOTS*ADDRESS_WIDTH-1:0]  r_history_address   = 0;
+    reg  [SLOTS*DATA_WIDTH-1:0]     r_history_data      = 0;
+    wire [2*SLOTS-1:0]              w_slot_valid        = { r_history_valid, write_enable };
+    wire [2*SLOTS*ADDRESS_WIDTH-1:0] w_slot_address     = { r_history_address, write_address };
+    wire [2*SLOTS*DATA_WIDTH-1:0]   w_slot_data         = { r_history_data, write_data };
+    always @( posedge clk ) begin
+        r_history_valid     <= w_slot_valid[SLOTS-1:0];
+        r_history_address   <= w_slot_address[SLOTS*ADDRESS_WIDTH-1:0];
+        r_history_data      <= w_slot_data[SLOTS*DATA_WIDTH-1:0];
+    end
+
+    // the slot data follows the memory read
+    wire [SLOTS*DATA_WIDTH-1:0] w_bypass_data;
+    ff_delay #( .WIDTH( SLOTS * DATA_WIDTH ), .DEPTH( READ_LATENCY ) ) bypass_delay
+    (
+        .clk(   clk ),
+        .D(     w_slot_data[SLOTS*DATA_WIDTH-1:0] ),
+        .Q(     w_bypass_data )
+    );
+
+    genvar port, slot;
+    generate
+        for( port = 0; port < READ_PORTS; port = port + 1 ) begin : bypass_port_loop
+            wire [SLOTS-1:0] w_match;
+            wire [SLOTS-1:0] w_bypass_match;
+            for( slot = 0; slot < SLOTS; slot = slot + 1 ) begin : bypass_compare_loop
+                math_pipelined_reduce #( .WIDTH( ADDRESS_WIDTH + 1 ), .LATENCY( COMPARE_LATENCY ), .OPERATION( "AND" ) ) address_compare
+                (
+                    .clk(       clk ),
+                    .I1(        { w_slot_valid[slot], ~( w_slot_address[slot*ADDRESS_WIDTH+:ADDRESS_WIDTH] ^ read_address[port*ADDRESS_WIDTH+:ADDRESS_WIDTH] ) } ),
+                    .result(    w_match[slot] )
+                );
+            end
+            ff_delay #( .WIDTH( SLOTS ), .DEPTH( READ_LATENCY - COMPARE_LATENCY ) ) match_delay ( .clk( clk ), .D( w_match ), .Q( w_bypass_match ) );
+
+            // the newest match wins, the oldest slot is checked first
+            reg [DATA_WIDTH-1:0] w_read;
+            integer idx;
+            always @(*) begin
+                w_read = w_memory_read[port*DATA_WIDTH+:DATA_WIDTH];
+                for( idx = SLOTS - 1; idx >= 0; idx = idx - 1 ) begin
+                    // within a clock the highest port is newest
+                    if( w_bypass_match[( idx / WRITE_PORTS ) * WRITE_PORTS + WRITE_PORTS - 1 - idx % WRITE_PORTS] )
+                        w_read = w_bypass_data[( ( idx / WRITE_PORTS ) * WRITE_PORTS + WRITE_PORTS - 1 - idx % WRITE_PORTS )*DATA_WIDTH+:DATA_WIDTH];
+                end
+            end
+            reg [DATA_WIDTH-1:0] r_read = 0;
+            always @( posedge clk ) r_read <= w_read;
+            assign read_data[port*DATA_WIDTH+:DATA_WIDTH] = r_read;
+        end
+    endgenerate
+endmodule
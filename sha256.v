@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	sha256.v
+//
+// Project:	sha-256
+//
+// Purpose:	Pipelined SHA-256 compression function using carry save adders
+//          with a single chunked carry propagate add per round. Fully unrolled
+//          or multi-message interleaved.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// sha256_pipelined - out_hash = in_hash + compress( in_hash, in_block )
+//  UNROLL          - round stages built, MUST divide 64. 
+//                    64: fully unrolled, 1 block per clock, 'in_ready' is always HIGH.
+//                    < 64: the stages form a ring that every block travels 64 / UNROLL times.
+//                    Up to UNROLL * ROUND_LATENCY independent blocks are interleaved in the ring.
+//                    A new block is accepted whenever the ring head is empty.
+//  ROUND_LATENCY   - clocks per round, the width of the chunks of the round adders.
+//  TAG_WIDTH       - user data that travels with the block, used to identify interleaved messages.
+//
+//  in_first        - use the SHA-256 initial hash value instead of 'in_hash'
+//  in_block        - 512 bit message block, word 0 in the msb. Padding is done by the caller
+//  in_hash         - chaining value, { H0, H1, ... H7 } H0 in the msb
+//  Multi block messages feed 'out_hash' back in as the next 'in_hash', with the ring full of
+//  other messages the chaining latency is hidden.
+//
+// Each round has 7 operands to add for 'a' and 6 for 'e', the message schedule has 4.
+// They are reduced to 2 with 3:2 carry save adders, then a single 'math_pipelined_add'.
+//  a = h + S1(e) + Ch(e,f,g) + K + W + S0(a) + Maj(a,b,c)
+//  e = h + S1(e) + Ch(e,f,g) + K + W + d
+//  W[t+16] = s1(W[t+14]) + W[t+9] + s0(W[t+1]) + W[t]
+// The message schedule is a 16 word window that shifts 1 word per round.
+// The hash is valid 64 * ROUND_LATENCY + ROUND_LATENCY clocks after the block enters the ring.
+module sha256_pipelined
+    #(
+        parameter UNROLL        = 64,
+        parameter ROUND_LATENCY = 1,
+        parameter TAG_WIDTH     = 1
+    )
+    (
+        input   wire                    clk,
+        input   wire                    rst,
+        input   wire                    in_valid,
+        output  wire                    in_ready,
+        input   wire                    in_first,
+        input   wire    [511:0]         in_block,
+        input   wire    [255:0]         in_hash,
+        input   wire    [TAG_WIDTH-1:0] in_tag,
+        output  wire                    out_valid,
+        output  wire    [255:0]         out_hash,
+        output  wire    [TAG_WIDTH-1:0] out_tag
+    );
+    localparam [255:0] SHA256_IV = 256'h6a09e667_bb67ae85_3c6ef372_a54ff53a_510e527f_9b05688c_1f83d9ab_5be0cd19;
+
+    // f_Sha256K - Returns the round constant
+    function automatic [31:0] f_Sha256K;
+        input [5:0] round;
+        case( round )
+            6'd0: f_Sha256K = 32'h428a2f98;
+            6'd1: f_Sha256K = 32'h71374491;
+            6'd2: f_Sha256K = 32'hb5c0fbcf;
+            6'd3: f_Sha256K = 32'he9b5dba5;
+            6'd4: f_Sha256K = 32'h3956c25b;
+            6'd5: f_Sha256K = 32'h59f111f1;
+            6'd6: f_Sha256K = 32'h923f82a4;
+            6'd7: f_Sha256K = 32'hab1c5ed5;
+            6'd8: f_Sha256K = 32'hd807aa98;
+            6'd9: f_Sha256K = 32'h12835b01;
+            6'd10: f_Sha256K = 32'h243185be;
+            6'd11: f_Sha256K = 32'h550c7dc3;
+            6'd12: f_Sha256K = 32'h72be5d74;
+            6'd13: f_Sha256K = 32'h80deb1fe;
+            6'd14: f_Sha256K = 32'h9bdc06a7;
+            6'd15: f_Sha256K = 32'hc19bf174;
+            6'd16: f_Sha256K = 32'he49b69c1;
+            6'd17: f_Sha256K = 32'hefbe4786;
+            6'd18: f_Sha256K = 32'h0fc19dc6;
+            6'd19: f_Sha256K = 32'h240ca1cc;
+            6'd20: f_Sha256K = 32'h2de92c6f;
+            6'd21: f_Sha256K = 32'h4a7484aa;
+            6'd22: f_Sha256K = 32'h5cb0a9dc;
+            6'd23: f_Sha256K = 32'h76f988da;
+            6'd24: f_Sha256K = 32'h983e5152;
+            6'd25: f_Sha256K = 32'ha831c66d;
+            6'd26: f_Sha256K = 32'hb00327c8;
+            6'd27: f_Sha256K = 32'hbf597fc7;
+            6'd28: f_Sha256K = 32'hc6e00bf3;
+            6'd29: f_Sha256K = 32'hd5a79147;
+            6'd30: f_Sha256K = 32'h06ca6351;
+            6'd31: f_Sha256K = 32'h14292967;
+            6'd32: f_Sha256K = 32'h27b70a85;
+            6'd33: f_Sha256K = 32'h2e1b2138;
+            6'd34: f_Sha256K = 32'h4d2c6dfc;
+            6'd35: f_Sha256K = 32'h53380d13;
+            6'd36: f_Sha256K = 32'h650a7354;
+            6'd37: f_Sha256K = 32'h766a0abb;
+            6'd38: f_Sha256K = 32'h81c2c92e;
+            6'd39: f_Sha256K = 32'h92722c85;
+            6'd40: f_Sha256K = 32'ha2bfe8a1;
+            6'd41: f_Sha256K = 32'ha81a664b;
+            6'd42: f_Sha256K = 32'hc24b8b70;
+            6'd43: f_Sha256K = 32'hc76c51a3;
+            6'd44: f_Sha256K = 32'hd192e819;
+            6'd45: f_Sha256K = 32'hd6990624;
+            6'd46: f_Sha256K = 32'hf40e3585;
+            6'd47: f_Sha256K = 32'h106aa070;
+            6'd48: f_Sha256K = 32'h19a4c116;
+            6'd49: f_Sha256K = 32'h1e376c08;
+            6'd50: f_Sha256K = 32'h2748774c;
+            6'd51: f_Sha256K = 32'h34b0bcb5;
+            6'd52: f_Sha256K = 32'h391c0cb3;
+            6'd53: f_Sha256K = 32'h4ed8aa4a;
+            6'd54: f_Sha256K = 32'h5b9cca4f;
+            6'd55: f_Sha256K = 32'h682e6ff3;
+            6'd56: f_Sha256K = 32'h748f82ee;
+            6'd57: f_Sha256K = 32'h78a5636f;
+            6'd58: f_Sha256K = 32'h84c87814;
+            6'd59: f_Sha256K = 32'h8cc70208;
+            6'd60: f_Sha256K = 32'h90befffa;
+            6'd61: f_Sha256K = 32'ha4506ceb;
+            6'd62: f_Sha256K = 32'hbef9a3f7;
+            6'd63: f_Sha256K = 32'hc67178f2;
+        endcase
+    endfunction
+    // f_Sha256Csa - 3:2 carry save adder, returns { carry, sum }
+    function automatic [63:0] f_Sha256Csa;
+        input [31:0] x, y, z;
+        f_Sha256Csa = { ((x & y) | (x & z) | (y & z)) << 1, x ^ y ^ z };
+    endfunction
+    `define sha256_rotr(x,n) ({ x, x } >> (n))
+
+    // ring bus, index 0 is the ring head, index UNROLL is the output of the last stage
+    wire [UNROLL:0]             w_valid;
+    wire [(UNROLL+1)*7-1:0]     w_round;
+    wire [(UNROLL+1)*256-1:0]   w_state;
+    wire [(UNROLL+1)*512-1:0]   w_window;
+    wire [(UNROLL+1)*256-1:0]   w_hash;
+    wire [(UNROLL+1)*TAG_WIDTH-1:0] w_tag;
+
+    // ring head, blocks that still have rounds left have priority over new blocks
+    wire            w_loop      = w_valid[UNROLL] && w_round[UNROLL*7+:7] != 7'd64;
+    wire [255:0]    w_hash_in   = in_first ? SHA256_IV : in_hash;
+    wire [511:0]    w_block_in;
+    genvar idx;
+    generate
+        for( idx = 0; idx < 16; idx = idx + 1 ) begin : sha256_block_loop
+            // window word 'n' is W[t+n]
+            assign w_block_in[idx*32+:32] = in_block[511-32*idx-:32];
+        end
+    endgenerate
+    assign in_ready                 = !w_loop;
+    assign w_valid[0]               = w_loop || in_valid;
+    assign w_round[6:0]             = w_loop ? w_round[UNROLL*7+:7]             : 7'd0;
+    assign w_state[255:0]           = w_loop ? w_state[UNROLL*256+:256]         : w_hash_in;
+    assign w_window[511:0]          = w_loop ? w_window[UNROLL*512+:512]        : w_block_in;
+    assign w_hash[255:0]            = w_loop ? w_hash[UNROLL*256+:256]          : w_hash_in;
+    assign w_tag[TAG_WIDTH-1:0]     = w_loop ? w_tag[UNROLL*TAG_WIDTH+:TAG_WIDTH] : in_tag;
+
+    genvar stage;
+    generate
+        for( stage = 0; stage < UNROLL; stage = stage + 1 ) begin : sha256_round_loop
+            localparam [5:0] STAGE = stage;
+            wire [6:0]      w_round_in  = w_round[stage*7+:7];
+            wire [511:0]    w_window_in = w_window[stage*512+:512];
+            wire [31:0]     a, b, c, d, e, f, g, h;
+            assign { a, b, c, d, e, f, g, h } = w_state[stage*256+:256];
+            // this stage only runs rounds where round mod UNROLL == stage, the low bits of the index are constant
+            wire [31:0]     w_K     = f_Sha256K( (w_round_in[5:0] & ~(UNROLL-1)) | STAGE );
+            wire [31:0]     w_W     = w_window_in[31:0];
+            wire [31:0]     w_S0    = `sha256_rotr(a,2) ^ `sha256_rotr(a,13) ^ `sha256_rotr(a,22);
+            wire [31:0]     w_S1    = `sha256_rotr(e,6) ^ `sha256_rotr(e,11) ^ `sha256_rotr(e,25);
+            wire [31:0]     w_ch    = (e & f) ^ (~e & g);
+            wire [31:0]     w_maj   = (a & b) ^ (a & c) ^ (b & c);
+            // carry save trees
+            wire [63:0]     w_csa_common    = f_Sha256Csa( h, w_S1, w_ch );
+            wire [63:0]     w_csa_a0        = f_Sha256Csa( w_K, w_W, w_S0 );
+            wire [63:0]     w_csa_a1        = f_Sha256Csa( w_csa_common[31:0], w_csa_common[63:32], w_csa_a0[31:0] );
+            wire [63:0]     w_csa_a2        = f_Sha256Csa( w_csa_a0[63:32], w_maj, w_csa_a1[31:0] );
+            wire [63:0]     w_csa_a3        = f_Sha256Csa( w_csa_a1[63:32], w_csa_a2[31:0], w_csa_a2[63:32] );
+            wire [63:0]     w_csa_e0        = f_Sha256Csa( w_K, w_W, d );
+            wire [63:0]     w_csa_e1        = f_Sha256Csa( w_csa_common[31:0], w_csa_common[63:32], w_csa_e0[31:0] );
+            wire [63:0]     w_csa_e2        = f_Sha256Csa( w_csa_e0[63:32], w_csa_e1[31:0], w_csa_e1[63:32] );
+            // message schedule
+            wire [31:0]     w_W1    = w_window_in[32+:32];
+            wire [31:0]     w_W14   = w_window_in[14*32+:32];
+            wire [31:0]     w_s0    = `sha256_rotr(w_W1,7) ^ `sha256_rotr(w_W1,18) ^ (w_W1 >> 3);
+            wire [31:0]     w_s1    = `sha256_rotr(w_W14,17) ^ `sha256_rotr(w_W14,19) ^ (w_W14 >> 10);
+            wire [63:0]     w_csa_w0        = f_Sha256Csa( w_s1, w_window_in[9*32+:32], w_s0 );
+            wire [63:0]     w_csa_w1        = f_Sha256Csa( w_W, w_csa_w0[31:0], w_csa_w0[63:32] );
+
+            wire [31:0]     w_a_next;
+            wire [31:0]     w_e_next;
+            wire [31:0]     w_W_next;
+            math_pipelined_add #( .WIDTH( 32 ), .LATENCY( ROUND_LATENCY ) ) a_add 
+                ( .clk( clk ), .I1( w_csa_a3[31:0] ), .I2( w_csa_a3[63:32] ), .cin( 1'b0 ), .sum( w_a_next ), .cout() );
+            math_pipelined_add #( .WIDTH( 32 ), .LATENCY( ROUND_LATENCY ) ) e_add 
+                ( .clk( clk ), .I1( w_csa_e2[31:0] ), .I2( w_csa_e2[63:32] ), .cin( 1'b0 ), .sum( w_e_next ), .cout() );
+            math_pipelined_add #( .WIDTH( 32 ), .LATENCY( ROUND_LATENCY ) ) w_add 
+                ( .clk( clk ), .I1( w_csa_w1[31:0] ), .I2( w_csa_w1[63:32] ), .cin( 1'b0 ), .sum( w_W_next ), .cout() );
+
+            // everything else is delayed to line up with the adders
+            wire [31:0]     d_a, d_b, d_c, d_e, d_f, d_g;
+            wire [479:0]    d_window;
+            ff_delay #( .WIDTH( 7+192+480+256+TAG_WIDTH ), .DEPTH( ROUND_LATENCY ) ) stage_delay
+            (
+                .clk(   clk ),
+                .D(     { w_round_in + 1'b1, a, b, c, e, f, g, w_window_in[511:32], w_hash[stage*256+:256], w_tag[stage*TAG_WIDTH+:TAG_WIDTH] } ),
+                .Q(     { w_round[(stage+1)*7+:7], d_a, d_b, d_c, d_e, d_f, d_g, d_window, w_hash[(stage+1)*256+:256], w_tag[(stage+1)*TAG_WIDTH+:TAG_WIDTH] } )
+            );
+            reg [ROUND_LATENCY-1:0] r_valid = 0;
+            always @( posedge clk ) begin
+                if( rst )
+                    r_valid <= 'd0;
+                else
+                    r_valid <= ( r_valid << 1 ) | w_valid[stage];
+            end
+            assign w_valid[stage+1]             = r_valid[ROUND_LATENCY-1];
+            assign w_state[(stage+1)*256+:256]  = { w_a_next, d_a, d_b, d_c, w_e_next, d_e, d_f, d_g };
+            assign w_window[(stage+1)*512+:512] = { w_W_next, d_window };
+        end
+    endgenerate
+    `undef sha256_rotr
+
+    // final add, out_hash = in_hash + state
+    wire w_done = w_valid[UNROLL] && w_round[UNROLL*7+:7] == 7'd64;
+    generate
+        for( idx = 0; idx < 8; idx = idx + 1 ) begin : sha256_final_loop
+            math_pipelined_add #( .WIDTH( 32 ), .LATENCY( ROUND_LATENCY ) ) hash_add
+            (
+                .clk(   clk ),
+                .I1(    w_hash[UNROLL*256+idx*32+:32] ),
+                .I2(    w_state[UNROLL*256+idx*32+:32] ),
+                .cin(   1'b0 ),
+                .sum(   out_hash[idx*32+:32] ),
+                .cout()
+            );
+        end
+    endgenerate
+    ff_delay #( .WIDTH( TAG_WIDTH ), .DEPTH( ROUND_LATENCY ) ) tag_delay ( .clk( clk ), .D( w_tag[UNROLL*TAG_WIDTH+:TAG_WIDTH] ), .Q( out_tag ) );
+    reg [ROUND_LATENCY-1:0] r_out_valid = 0;
+    always @( posedge clk ) begin
+        if( rst )
+            r_out_valid <= 'd0;
+        else
+            r_out_valid <= ( r_out_valid << 1 ) | w_done;
+    end
+    assign out_valid = r_out_valid[ROUND_LATENCY-1];
+endmodule
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	shared_unit.v
+//
+// Project:	shared unit
+//
+// Purpose:	Round robin arbiter and result routing that lets several clients
+//          share a single fixed latency pipelined unit.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// shared_unit - CLIENTS requesters share 1 pipelined unit
+//  The unit is connected to the unit_* ports, it MUST accept an operation every clock and return
+//  the result exactly 'LATENCY' clocks later, math_pipelined_multiply, math_sqrt with ITERATIVE 0,
+//  gf_multiplier, newton_raphson, ...
+//
+//  client n requests with req_valid[n] and req_operands[n*OPERAND_WIDTH+:OPERAND_WIDTH], the request
+//  is taken on the clock req_ready[n] is set. Only 1 client is granted per clock, round robin
+//  starting after the last client granted, so every waiting client is served within CLIENTS clocks
+//  and the unit is issued an operation every clock any client is requesting.
+//  The granted operands are registered into the unit with the client id as a tag. The tag travels
+//  beside the unit for 'LATENCY' clocks, resp_valid[n] is set when client n's result is on
+//  resp_result, 1 + LATENCY clocks after its request was taken.
+module shared_unit
+    #(
+        parameter CLIENTS       = 4,
+        parameter OPERAND_WIDTH = 32,
+        parameter RESULT_WIDTH  = 32,
+        parameter LATENCY       = 2
+    )
+    (
+        input   wire                                clk,
+        input   wire                                rst,
+        // clients
+        input   wire    [CLIENTS-1:0]               req_valid,
+        output  wire    [CLIENTS-1:0]               req_ready,
+        input   wire    [CLIENTS*OPERAND_WIDTH-1:0] req_operands,
+        output  wire    [CLIENTS-1:0]               resp_valid,
+        output  wire    [RESULT_WIDTH-1:0]          resp_result,
+        // shared unit
+        output  wire                                unit_valid,
+        output  wire    [OPERAND_WIDTH-1:0]         unit_operands,
+        input   wire    [RESULT_WIDTH-1:0]          unit_result
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    localparam TAG_WIDTH = f_Log2( CLIENTS );   // bits needed to hold a client id
+
+    // round robin, the lowest request above the last grant wins, otherwise the lowest request
+    reg  [CLIENTS-1:0]  r_last_grant    = 1;
+    wire [CLIENTS-1:0]  w_above         = ~( ( r_last_grant << 1 ) - 1'b1 );
+    wire [CLIENTS-1:0]  w_masked        = req_valid & w_above;
+    wire [CLIENTS-1:0]  w_candidates    = |w_masked ? w_masked : req_valid;
+    wire [CLIENTS-1:0]  w_grant         = w_candidates & ( ~w_candidates + 1'b1 );
+    assign req_ready = w_grant;
+
+    // operand mux and client id encode
+    reg [OPERAND_WIDTH-1:0] w_operands;
+    reg [TAG_WIDTH-1:0]     w_tag;
+    integer client;
+    always @(*) begin
+        w_operands  = 'd0;
+        w_tag       = 'd0;
+        for( client = 0; client < CLIENTS; client = client + 1 ) begin
+            if( w_grant[client] ) begin
+                w_operands  = w_operands | req_operands[client*OPERAND_WIDTH+:OPERAND_WIDTH];
+                w_tag       = w_tag | client;
+            end
+        end
+    end
+
+    reg [OPERAND_WIDTH-1:0] r_operands  = 0;
+    reg [TAG_WIDTH-1:0]     r_tag       = 0;
+    reg [LATENCY:0]         r_valid     = 0;
+    assign unit_valid       = r_valid[0];
+    assign unit_operands    = r_operands;
+    always @( posedge clk ) begin
+        r_operands  <= w_operands;
+        r_tag       <= w_tag;
+        if( rst ) begin
+            r_last_grant    <= 1;
+            r_valid         <= 'd0;
+        end else begin
+            if( |req_valid )
+                r_last_grant <= w_grant;
+            r_valid <= ( r_valid << 1 ) | |req_valid;
+        end
+    end
+
+    // route the result back
+    wire [TAG_WIDTH-1:0] w_result_tag;
+    ff_delay #( .WIDTH( TAG_WIDTH ), .DEPTH( LATENCY ) ) tag_delay ( .clk( clk ), .D( r_tag ), .Q( w_result_tag ) );
+    assign resp_result = unit_result;
+    genvar idx;
+    generate
+        for( idx = 0; idx < CLIENTS; idx = idx + 1 ) begin : response_loop
+            assign resp_valid[idx] = r_valid[LATENCY] && w_result_tag == idx;
+        end
+    endgenerate
+endmodule
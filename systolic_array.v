@@ -0,0 +1,282 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	systolic_array.v
+//
+// Project:	systolic array
+//
+// Purpose:	Output stationary systolic matrix multiply built from pipelined
+//          MAC cells. 1 N x N tile every N clocks.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// systolic_array - C = A * B, N x N tiles
+//  Each valid clock takes column k of A, a_column[i*A_WIDTH+:A_WIDTH] = A[i][k], and row k of B,
+//  b_row[j*B_WIDTH+:B_WIDTH] = B[k][j]. N valid clocks make a tile, k = 0 first. in_valid may
+//  drop between columns, back to back tiles keep every cell busy.
+//  The rows of C leave in order, out_row[j*ACC_WIDTH+:ACC_WIDTH] = C[i][j], out_first marks row 0.
+//  N MUST BE >= 2, ACC_WIDTH MUST BE >= A_WIDTH + B_WIDTH + log2( N )
+//
+//  feeders     row i of A and column j of B are delayed i and j clocks so A[i][k] meets B[k][j] in cell (i,j).
+//              A travels right and B travels down through the forwarding registers of the cells.
+//  MAC cell    a math_pipelined_multiply product, MULT_LATENCY, into a chunked accumulator. Each ALU_WIDTH
+//              chunk keeps its carry out in a register that is added into the next chunk on the next clock,
+//              so the carries never ripple. The accumulator is left in this carry save form.
+//  drain       each column has a chain of registers moving down. The 'inject' flag travels with A, cell (i,j)
+//              loads its finished accumulator into the chain i + 1 clocks after it finishes, which lines the
+//              rows up one behind the other at the bottom of the column. The columns are deskewed and the
+//              carry save accumulators are resolved by a math_pipelined_add per column, ADD_LATENCY.
+module systolic_array
+    #(
+        parameter N             = 8,
+        parameter A_WIDTH       = 8,
+        parameter B_WIDTH       = 8,
+        parameter ACC_WIDTH     = 20,
+        parameter SIGNED        = 1,
+        parameter ALU_WIDTH     = 8,
+        parameter MULT_LATENCY  = 2,
+        parameter ADD_LATENCY   = 2,
+        parameter DSP           = 1
+    )
+    (
+        input   wire                        clk,
+        input   wire                        rst,
+        input   wire                        in_valid,
+        input   wire    [N*A_WIDTH-1:0]     a_column,
+        input   wire    [N*B_WIDTH-1:0]     b_row,
+        output  wire                        out_valid,
+        output  wire                        out_first,
+        output  wire    [N*ACC_WIDTH-1:0]   out_row
+    );
+    localparam CHUNK_COUNT  = ACC_WIDTH % ALU_WIDTH == 0 ? ACC_WIDTH / ALU_WIDTH : ACC_WIDTH / ALU_WIDTH + 1;
+    localparam HOLD_WIDTH   = ACC_WIDTH + CHUNK_COUNT;  // { carries, sum }
+    localparam FLAG_WIDTH   = 4;                        // { inject, last, first, valid }
+    localparam DRAIN_WIDTH  = HOLD_WIDTH + 2;           // { first, valid, hold }
+
+    // position in the tile, one hot
+    reg [N-1:0] r_k = 1;
+    always @( posedge clk ) begin
+        if( rst )
+            r_k <= 1;
+        else if( in_valid )
+            r_k <= { r_k[N-2:0], r_k[N-1] };
+    end
+    wire w_first    = in_valid & r_k[0];
+    wire w_last     = in_valid & r_k[N-1];
+
+    // cell interconnect, index [row][column]. a and the flags enter from the left, b and the drain enter from the top
+    wire [(N+1)*N*A_WIDTH-1:0]      w_a;
+    wire [(N+1)*N*FLAG_WIDTH-1:0]   w_flags;
+    wire [(N+1)*N*B_WIDTH-1:0]      w_b;
+    wire [(N+1)*N*DRAIN_WIDTH-1:0]  w_drain;
+
+    genvar row, column, idx;
+    generate
+        // skewed feeders
+        for( row = 0; row < N; row = row + 1 ) begin : row_feeder_loop
+            wire w_inject;
+            ff_delay #( .WIDTH( A_WIDTH + 3 ), .DEPTH( row ) ) a_skew
+            (
+                .clk(   clk ),
+                .D(     { w_last, w_first, in_valid, a_column[row*A_WIDTH+:A_WIDTH] } ),
+                .Q(     { w_flags[(row*(N+1))*FLAG_WIDTH+:3], w_a[(row*(N+1))*A_WIDTH+:A_WIDTH] } )
+            );
+            ff_delay #( .WIDTH( 1 ), .DEPTH( 2 * row + 1 ) ) inject_delay ( .clk( clk ), .D( w_last ), .Q( w_inject ) );
+            assign w_flags[(row*(N+1))*FLAG_WIDTH+3] = w_inject;
+        end
+        for( column = 0; column < N; column = column + 1 ) begin : column_feeder_loop
+            ff_delay #( .WIDTH( B_WIDTH ), .DEPTH( column ) ) b_skew
+            (
+                .clk(   clk ),
+                .D(     b_row[column*B_WIDTH+:B_WIDTH] ),
+                .Q(     w_b[column*B_WIDTH+:B_WIDTH] )
+            );
+            assign w_drain[column*DRAIN_WIDTH+:DRAIN_WIDTH] = 'd0;
+        end
+
+        // MAC grid. a is indexed row*(N+1)+column, b and drain are indexed row*N+column
+        for( row = 0; row < N; row = row + 1 ) begin : mac_row_loop
+            for( column = 0; column < N; column = column + 1 ) begin : mac_column_loop
+                systolic_mac
+                    #(
+                        .A_WIDTH(       A_WIDTH ),
+                        .B_WIDTH(       B_WIDTH ),
+                        .ACC_WIDTH(     ACC_WIDTH ),
+                        .SIGNED(        SIGNED ),
+                        .ALU_WIDTH(     ALU_WIDTH ),
+                        .MULT_LATENCY(  MULT_LATENCY ),
+                        .DSP(           DSP ),
+                        .FIRST_ROW(     row == 0 )
+                    )
+                    mac
+                    (
+                        .clk(           clk ),
+                        .rst(           rst ),
+                        .a_in(          w_a[(row*(N+1)+column)*A_WIDTH+:A_WIDTH] ),
+                        .flags_in(      w_flags[(row*(N+1)+column)*FLAG_WIDTH+:FLAG_WIDTH] ),
+                        .b_in(          w_b[(row*N+column)*B_WIDTH+:B_WIDTH] ),
+                        .drain_in(      w_drain[(row*N+column)*DRAIN_WIDTH+:DRAIN_WIDTH] ),
+                        .a_out(         w_a[(row*(N+1)+column+1)*A_WIDTH+:A_WIDTH] ),
+                        .flags_out(     w_flags[(row*(N+1)+column+1)*FLAG_WIDTH+:FLAG_WIDTH] ),
+                        .b_out(         w_b[((row+1)*N+column)*B_WIDTH+:B_WIDTH] ),
+                        .drain_out(     w_drain[((row+1)*N+column)*DRAIN_WIDTH+:DRAIN_WIDTH] )
+                    );
+            end
+        end
+
+        // deskew the columns and resolve the carry save accumulators
+        for( column = 0; column < N; column = column + 1 ) begin : drain_column_loop
+            wire [DRAIN_WIDTH-1:0]  w_bottom;
+            wire [ACC_WIDTH-1:0]    w_carries;
+            ff_delay #( .WIDTH( DRAIN_WIDTH ), .DEPTH( N - 1 - column ) ) drain_deskew
+            (
+                .clk(   clk ),
+                .D(     w_drain[(N*N+column)*DRAIN_WIDTH+:DRAIN_WIDTH] ),
+                .Q(     w_bottom )
+            );
+            // the carry out of chunk idx belongs to the lsb of chunk idx + 1, the top carry is dropped
+            for( idx = 0; idx < ACC_WIDTH; idx = idx + 1 ) begin : carry_position_loop
+                if( idx % ALU_WIDTH == 0 && idx != 0 )
+                    assign w_carries[idx] = w_bottom[ACC_WIDTH+idx/ALU_WIDTH-1];
+                else
+                    assign w_carries[idx] = 1'b0;
+            end
+            math_pipelined_add #( .WIDTH( ACC_WIDTH ), .LATENCY( ADD_LATENCY ) ) resolve_add
+            (
+                .clk(   clk ),
+                .I1(    w_bottom[ACC_WIDTH-1:0] ),
+                .I2(    w_carries ),
+                .cin(   1'b0 ),
+                .sum(   out_row[column*ACC_WIDTH+:ACC_WIDTH] ),
+                .cout()
+            );
+            if( column == N - 1 ) begin
+                ff_delay #( .WIDTH( 2 ), .DEPTH( ADD_LATENCY ) ) flag_delay
+                (
+                    .clk(   clk ),
+                    .D(     w_bottom[HOLD_WIDTH+:2] ),
+                    .Q(     { out_first, out_valid } )
+                );
+            end
+        end
+    endgenerate
+endmodule
+
+// systolic_mac - 1 cell of 'systolic_array'
+//  a and its flags are forwarded right, b is forwarded down, 1 clock per cell.
+//  flags { inject, last, first, valid }
+//      valid   - a is part of a tile
+//      first   - k = 0, the accumulator restarts
+//      last    - k = N - 1, the accumulator is copied to the hold register
+//      inject  - the hold register replaces the drain chain value
+module systolic_mac
+    #(
+        parameter A_WIDTH       = 8,
+        parameter B_WIDTH       = 8,
+        parameter ACC_WIDTH     = 20,
+        parameter SIGNED        = 1,
+        parameter ALU_WIDTH     = 8,
+        parameter MULT_LATENCY  = 2,
+        parameter DSP           = 1,
+        parameter FIRST_ROW     = 0,
+        // { carries, sum }, do not override
+        parameter HOLD_WIDTH    = ACC_WIDTH + ( ACC_WIDTH % ALU_WIDTH == 0 ? ACC_WIDTH / ALU_WIDTH : ACC_WIDTH / ALU_WIDTH + 1 )
+    )
+    (
+        input   wire                                clk,
+        input   wire                                rst,
+        input   wire    [A_WIDTH-1:0]               a_in,
+        input   wire    [3:0]                       flags_in,
+        input   wire    [B_WIDTH-1:0]               b_in,
+        input   wire    [HOLD_WIDTH+1:0]            drain_in,
+        output  wire    [A_WIDTH-1:0]               a_out,
+        output  wire    [3:0]                       flags_out,
+        output  wire    [B_WIDTH-1:0]               b_out,
+        output  wire    [HOLD_WIDTH+1:0]            drain_out
+    );
+    localparam CHUNK_COUNT = ACC_WIDTH % ALU_WIDTH == 0 ? ACC_WIDTH / ALU_WIDTH : ACC_WIDTH / ALU_WIDTH + 1;
+
+    // forwarding registers
+    reg [A_WIDTH-1:0]   r_a     = 0;
+    reg [3:0]           r_flags = 0;
+    reg [B_WIDTH-1:0]   r_b     = 0;
+    assign a_out        = r_a;
+    assign flags_out    = r_flags;
+    assign b_out        = r_b;
+    always @( posedge clk ) begin
+        r_a <= a_in;
+        r_b <= b_in;
+        if( rst )
+            r_flags <= 'd0;
+        else
+            r_flags <= flags_in;
+    end
+
+    // multiply, the flags follow the product
+    wire [A_WIDTH+B_WIDTH-1:0]  w_product;
+    wire                        w_valid;
+    wire                        w_first;
+    wire                        w_last;
+    wire                        w_inject;
+    math_pipelined_multiply #( .WIDTH_A( A_WIDTH ), .WIDTH_B( B_WIDTH ), .LATENCY( MULT_LATENCY ), .SIGNED( SIGNED ), .DSP( DSP ) ) mac_multiply
+    (
+        .clk(       clk ),
+        .I1(        a_in ),
+        .I2(        b_in ),
+        .product(   w_product )
+    );
+    ff_delay #( .WIDTH( 4 ), .DEPTH( MULT_LATENCY ) ) flag_delay ( .clk( clk ), .D( flags_in ), .Q( { w_inject, w_last, w_first, w_valid } ) );
+    wire [ACC_WIDTH-1:0] w_addend = w_valid
+        ? { { (ACC_WIDTH-A_WIDTH-B_WIDTH){ SIGNED ? w_product[A_WIDTH+B_WIDTH-1] : 1'b0 } }, w_product }
+        : 'd0;
+
+    // chunked accumulator, { carries, sum }
+    wire [ACC_WIDTH-1:0]    w_sum;
+    wire [CHUNK_COUNT-1:0]  w_carries;
+    math_pipelined_accumulator #( .WIDTH( ACC_WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) mac_accumulator
+    (
+        .clk(           clk ),
+        .clear(         1'b0 ),
+        .enable(        w_valid ),
+        .restart(       w_first ),
+        .I1(            w_addend ),
+        .next_sum(      w_sum ),
+        .next_carries(  w_carries ),
+        .sum(),
+        .carries()
+    );
+
+    // hold and drain
+    reg [HOLD_WIDTH-1:0]    r_hold  = 0;
+    reg [HOLD_WIDTH+1:0]    r_drain = 0;
+    assign drain_out = r_drain;
+    always @( posedge clk ) begin
+        if( w_last )
+            r_hold      <= { w_carries, w_sum };
+        if( rst )
+            r_drain     <= 'd0;
+        else if( w_inject )
+            r_drain     <= { FIRST_ROW ? 1'b1 : 1'b0, 1'b1, r_hold };
+        else
+            r_drain     <= drain_in;
+    end
+endmodule
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	test_bench.v
+//
+// Project:	test benches
+//
+// Purpose:	the parts the test benches share, included inside the bench module.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+
+// The bench declares, before the include:
+//  BENCH       a localparam string, the name in the messages
+//  TIMEOUT     a localparam, the simulation time after which the bench fails
+//  clk         the bench clock
+//  w_idle      HIGH when nothing is in flight
+// Checks add to r_errors. test_bench_finish ends the simulation and exits non-zero with $fatal when
+// r_errors is not 0, so a script can tell a failed bench from the exit code.
+// The tasks start and end 1 time unit after a rising edge of clk.
+
+integer r_errors    = 0;
+integer r_checked   = 0;
+integer r_max_input = 0;
+real    r_max_error = 0.0;
+
+initial begin
+    #( TIMEOUT );
+    $display( "%s: timeout, FAIL", BENCH );
+    $fatal( 1 );
+end
+
+//  f_Data - Returns the test word for an address and a pass
+function [15:0] f_Data;
+    input integer address, pass;
+    f_Data = ( address * 16'h9e37 ) ^ ( pass * 16'h5a5a ) ^ 16'h0f0f;
+endfunction
+
+//  wait_idle - waits until w_idle has been HIGH for 16 clocks
+task wait_idle;
+    integer quiet;
+    begin
+        quiet = 0;
+        while( quiet < 16 ) begin
+            @( posedge clk ); #1;
+            quiet = w_idle ? quiet + 1 : 0;
+        end
+    end
+endtask
+
+//  check_ulps - keeps the largest | result - expected | in r_max_error and its input in r_max_input
+task check_ulps;
+    input integer   in;
+    input real      result;
+    input real      expected;
+    real            error;
+    begin
+        error = result - expected;
+        if( error < 0.0 )
+            error = -error;
+        if( error > r_max_error ) begin
+            r_max_error = error;
+            r_max_input = in;
+        end
+        r_checked = r_checked + 1;
+    end
+endtask
+
+//  test_bench_finish - prints PASS and ends the simulation, or prints FAIL and exits non-zero
+task test_bench_finish;
+    begin
+        if( r_errors != 0 ) begin
+            $display( "%s: %0d errors, FAIL", BENCH, r_errors );
+            $fatal( 1 );
+        end
+        $display( "%s: PASS", BENCH );
+        $finish;
+    end
+endtask
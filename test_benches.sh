@@ -0,0 +1,48 @@
+#!/bin/sh
+# test_benches.sh - builds and runs every test bench with iverilog, from the directory above toolbox:
+#   sh toolbox/test_benches.sh
+# A bench passes when vvp exits with 0 and prints "<bench>: PASS". The failed runs are listed at the
+# end and the script exits non-zero.
+
+work=${TMPDIR:-/tmp}/toolbox_test_benches
+mkdir -p "$work"
+failed=""
+
+# run <name> <iverilog arguments>
+run() {
+    name=$1
+    shift
+    echo "== $name"
+    if iverilog -g2012 -o "$work/$name.vvp" "$@"; then
+        vvp -n "$work/$name.vvp" > "$work/$name.log" 2>&1
+        status=$?
+        cat "$work/$name.log"
+        if [ $status -ne 0 ] || ! grep -q ": PASS$" "$work/$name.log"; then
+            failed="$failed $name"
+        fi
+    else
+        failed="$failed $name"
+    fi
+}
+
+for function in EXP2 LOG2 RECIPROCAL SQRT; do
+    run function_evaluator_$function -s function_evaluator_tb -P function_evaluator_tb.FUNCTION=\"$function\" \
+        toolbox/function_evaluator_tb.v toolbox/function_evaluator.v toolbox/math_pipelined.v toolbox/flipflops.v
+done
+for function in RECIPROCAL RSQRT; do
+    run newton_raphson_$function -s newton_raphson_tb -P newton_raphson_tb.FUNCTION=\"$function\" \
+        toolbox/newton_raphson_tb.v toolbox/newton_raphson.v toolbox/math_pipelined.v toolbox/flipflops.v
+done
+run ddr_io -s ddr_io_tb -DTEST_BENCH_RUNNING toolbox/ddr_io_tb.v toolbox/ddr_io.v
+run tmds -s tmds_tb toolbox/tmds_tb.v toolbox/tmds.v toolbox/math_pipelined.v toolbox/flipflops.v
+run hyperram -s hyperram_tb toolbox/hyperram_tb.v toolbox/hyperram.v toolbox/fifo.v
+for write_back in 1 0; do
+    run cache_write_back_$write_back -s cache_tb -P cache_tb.WRITE_BACK=$write_back toolbox/cache_tb.v toolbox/cache.v \
+        toolbox/hyperram.v toolbox/fifo.v toolbox/bsram.v toolbox/math_pipelined.v toolbox/flipflops.v
+done
+
+if [ -n "$failed" ]; then
+    echo "FAILED:$failed"
+    exit 1
+fi
+echo "all test benches PASS"
@@ -0,0 +1,281 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	tmds.v
+//
+// Project:	tmds
+//
+// Purpose:	Pipelined TMDS encoder for DVI / HDMI and a video timing
+//          generator.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// tmds_encoder - the DVI 1.0 TMDS encoder, 1 symbol per clock
+//  tmds is the symbol of data / control, control while de is clear, exactly LATENCY = 2 * POPCOUNT_LATENCY + 2
+//  clocks later. tmds[0] is sent first. rst clears the running disparity after the symbol of that clock.
+//  tmds_tb.v compares it with a reference encoder written from the DVI flow chart.
+//  The 2 ones counts, of data and of the transition minimized word q_m, are math_pipelined_adder_tree
+//  trees of 8 1 bit operands taking POPCOUNT_LATENCY clocks, so only the running disparity update is left
+//  in a single clock, a 6 bit add selected by the sign of the disparity and the ones count of q_m.
+//      data -> ones count -> q_m -> ones count -> disparity and symbol
+module tmds_encoder
+    #(
+        parameter POPCOUNT_LATENCY = 1
+    )
+    (
+        input   wire            clk,
+        input   wire            rst,
+        input   wire            de,
+        input   wire [1:0]      control,
+        input   wire [7:0]      data,
+        output  wire [9:0]      tmds
+    );
+    localparam LATENCY = 2 * POPCOUNT_LATENCY + 2;
+
+    genvar idx;
+
+    // ones count of data
+    wire [8*4-1:0] w_data_bits;
+    generate
+        for( idx = 0; idx < 8; idx = idx + 1 ) begin : data_bit_loop
+            assign w_data_bits[idx*4+:4] = { 3'd0, data[idx] };
+        end
+    endgenerate
+    wire [3:0] w_data_ones;
+    math_pipelined_adder_tree #( .WIDTH( 4 ), .COUNT( 8 ), .LATENCY( POPCOUNT_LATENCY ) ) data_popcount
+    (
+        .clk(   clk ),
+        .I1(    w_data_bits ),
+        .sum(   w_data_ones )
+    );
+    wire [7:0] w_data;
+    wire       w_data_de;
+    wire [1:0] w_data_control;
+    ff_delay #( .WIDTH( 11 ), .DEPTH( POPCOUNT_LATENCY ) ) data_delay
+    (
+        .clk(   clk ),
+        .D(     { data, de, control } ),
+        .Q(     { w_data, w_data_de, w_data_control } )
+    );
+
+    // transition minimized q_m, xnor when there are more than 4 ones, or 4 and data[0] is 0
+    wire        w_xnor = w_data_ones > 4'd4 || ( w_data_ones == 4'd4 && !w_data[0] );
+    wire [7:0]  w_qm;
+    assign w_qm[0] = w_data[0];
+    generate
+        for( idx = 1; idx < 8; idx = idx + 1 ) begin : qm_loop
+            assign w_qm[idx] = w_qm[idx-1] ^ w_data[idx] ^ w_xnor;
+        end
+    endgenerate
+    reg  [8:0]  r_qm        = 0;
+    reg         r_qm_de     = 0;
+    reg  [1:0]  r_qm_control = 0;
+    always @( posedge clk ) begin
+        r_qm            <= { !w_xnor, w_qm };
+        r_qm_de         <= w_data_de;
+        r_qm_control    <= w_data_control;
+    end
+
+    // ones count of q_m
+    wire [8*4-1:0] w_qm_bits;
+    generate
+        for( idx = 0; idx < 8; idx = idx + 1 ) begin : qm_bit_loop
+            assign w_qm_bits[idx*4+:4] = { 3'd0, r_qm[idx] };
+        end
+    endgenerate
+    wire [3:0] w_qm_ones;
+    math_pipelined_adder_tree #( .WIDTH( 4 ), .COUNT( 8 ), .LATENCY( POPCOUNT_LATENCY ) ) qm_popcount
+    (
+        .clk(   clk ),
+        .I1(    w_qm_bits ),
+        .sum(   w_qm_ones )
+    );
+    wire [8:0] w_symbol_qm;
+    wire       w_symbol_de;
+    wire [1:0] w_symbol_control;
+    ff_delay #( .WIDTH( 12 ), .DEPTH( POPCOUNT_LATENCY ) ) qm_delay
+    (
+        .clk(   clk ),
+        .D(     { r_qm, r_qm_de, r_qm_control } ),
+        .Q(     { w_symbol_qm, w_symbol_de, w_symbol_control } )
+    );
+
+    // running disparity, ones - zeros of the symbols sent, in 6 bit 2's complement
+    reg  [5:0]  r_disparity = 0;
+    reg  [9:0]  r_tmds      = 0;
+    wire [5:0]  w_difference = { 1'b0, w_qm_ones, 1'b0 } - 6'd8;  // ones - zeros of q_m[7:0]
+    reg  [9:0]  w_tmds;
+    reg  [5:0]  w_disparity;
+    assign tmds = r_tmds;
+    always @(*) begin
+        if( !w_symbol_de ) begin
+            w_disparity = 6'd0;
+            case( w_symbol_control )
+                2'b00:      w_tmds = 10'b1101010100;
+                2'b01:      w_tmds = 10'b0010101011;
+                2'b10:      w_tmds = 10'b0101010100;
+                default:    w_tmds = 10'b1010101011;
+            endcase
+        end else if( r_disparity == 6'd0 || w_qm_ones == 4'd4 ) begin
+            w_tmds      = { !w_symbol_qm[8], w_symbol_qm[8], w_symbol_qm[8] ? w_symbol_qm[7:0] : ~w_symbol_qm[7:0] };
+            w_disparity = w_symbol_qm[8] ? r_disparity + w_difference : r_disparity - w_difference;
+        end else if( ( !r_disparity[5] && w_qm_ones > 4'd4 ) || ( r_disparity[5] && w_qm_ones < 4'd4 ) ) begin
+            w_tmds      = { 1'b1, w_symbol_qm[8], ~w_symbol_qm[7:0] };
+            w_disparity = r_disparity + { w_symbol_qm[8], 1'b0 } - w_difference;
+        end else begin
+            w_tmds      = { 1'b0, w_symbol_qm[8], w_symbol_qm[7:0] };
+            w_disparity = r_disparity - { !w_symbol_qm[8], 1'b0 } + w_difference;
+        end
+    end
+    always @( posedge clk ) begin
+        r_tmds      <= w_tmds;
+        r_disparity <= w_disparity;
+        if( rst )
+            r_disparity <= 6'd0;
+    end
+endmodule
+
+// video_timing - video sync and data enable from cascaded segment counters
+//  Every line is H_ACTIVE, H_FRONT, H_SYNC and H_BACK pixels, every frame V_ACTIVE, V_FRONT, V_SYNC and V_BACK
+//  lines. The segment of each axis is a counter_chunked loaded with ~( length - 1 ), its registered 'full'
+//  flag marks the last pixel / line of the segment and loads the next one, and the vertical counter steps
+//  on the last pixel of each line, so there are no wide compares against the timing. The _POLARITY
+//  parameters are the active level of the syncs. x / y are the position in the active picture.
+//  All the outputs are registered and belong to the same pixel, rst starts a frame at pixel 0, 0.
+module video_timing
+    #(
+        parameter WIDTH             = 12,
+        parameter ALU_WIDTH         = 4,
+        parameter H_ACTIVE          = 640,
+        parameter H_FRONT           = 16,
+        parameter H_SYNC            = 96,
+        parameter H_BACK            = 48,
+        parameter V_ACTIVE          = 480,
+        parameter V_FRONT           = 10,
+        parameter V_SYNC            = 2,
+        parameter V_BACK            = 33,
+        parameter H_SYNC_POLARITY   = 1'b0,
+        parameter V_SYNC_POLARITY   = 1'b0
+    )
+    (
+        input   wire                clk,
+        input   wire                rst,
+        output  wire                hsync,
+        output  wire                vsync,
+        output  wire                de,
+        output  wire [WIDTH-1:0]    x,
+        output  wire [WIDTH-1:0]    y,
+        output  wire                frame_end
+    );
+    localparam SEGMENT_ACTIVE   = 0;
+    localparam SEGMENT_FRONT    = 1;
+    localparam SEGMENT_SYNC     = 2;
+    localparam SEGMENT_BACK     = 3;
+
+    reg  [1:0]          r_h_segment = SEGMENT_ACTIVE;
+    reg  [1:0]          r_v_segment = SEGMENT_ACTIVE;
+    wire                w_h_full;
+    wire                w_v_full;
+    wire                w_line_end  = w_h_full && r_h_segment == SEGMENT_BACK;
+    wire                w_frame_end = w_line_end && w_v_full && r_v_segment == SEGMENT_BACK;
+    reg  [WIDTH-1:0]    w_h_length;     // ~( length - 1 ) of the next segment
+    reg  [WIDTH-1:0]    w_v_length;
+    always @(*) begin
+        case( r_h_segment )
+            SEGMENT_ACTIVE: w_h_length = ~( H_FRONT - 1 );
+            SEGMENT_FRONT:  w_h_length = ~( H_SYNC - 1 );
+            SEGMENT_SYNC:   w_h_length = ~( H_BACK - 1 );
+            default:        w_h_length = ~( H_ACTIVE - 1 );
+        endcase
+        case( r_v_segment )
+            SEGMENT_ACTIVE: w_v_length = ~( V_FRONT - 1 );
+            SEGMENT_FRONT:  w_v_length = ~( V_SYNC - 1 );
+            SEGMENT_SYNC:   w_v_length = ~( V_BACK - 1 );
+            default:        w_v_length = ~( V_ACTIVE - 1 );
+        endcase
+    end
+
+    counter_chunked #( .WIDTH( WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) h_segment_counter
+    (
+        .clk(           clk ),
+        .rst(           1'b0 ),
+        .load(          rst || w_h_full ),
+        .load_value(    rst ? ~( H_ACTIVE - 1 ) : w_h_length ),
+        .enable(        1'b1 ),
+        .count(),
+        .full(          w_h_full )
+    );
+    counter_chunked #( .WIDTH( WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) v_segment_counter
+    (
+        .clk(           clk ),
+        .rst(           1'b0 ),
+        .load(          rst || ( w_line_end && w_v_full ) ),
+        .load_value(    rst ? ~( V_ACTIVE - 1 ) : w_v_length ),
+        .enable(        w_line_end ),
+        .count(),
+        .full(          w_v_full )
+    );
+    wire w_h_active = r_h_segment == SEGMENT_ACTIVE;
+    wire w_v_active = r_v_segment == SEGMENT_ACTIVE;
+    wire [WIDTH-1:0] w_x;
+    wire [WIDTH-1:0] w_y;
+    counter_chunked #( .WIDTH( WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) x_counter
+    (
+        .clk(           clk ),
+        .rst(           rst ),
+        .load(          w_line_end ),
+        .load_value(    { WIDTH{1'b0} } ),
+        .enable(        w_h_active ),
+        .count(         w_x ),
+        .full()
+    );
+    counter_chunked #( .WIDTH( WIDTH ), .ALU_WIDTH( ALU_WIDTH ) ) y_counter
+    (
+        .clk(           clk ),
+        .rst(           rst ),
+        .load(          w_frame_end ),
+        .load_value(    { WIDTH{1'b0} } ),
+        .enable(        w_line_end && w_v_active ),
+        .count(         w_y ),
+        .full()
+    );
+
+    always @( posedge clk ) begin
+        if( w_h_full )
+            r_h_segment <= r_h_segment + 1'b1;
+        if( w_line_end && w_v_full )
+            r_v_segment <= r_v_segment + 1'b1;
+        if( rst ) begin
+            r_h_segment <= SEGMENT_ACTIVE;
+            r_v_segment <= SEGMENT_ACTIVE;
+        end
+    end
+
+    wire w_hsync = ( r_h_segment == SEGMENT_SYNC ) ? H_SYNC_POLARITY : !H_SYNC_POLARITY;
+    wire w_vsync = ( r_v_segment == SEGMENT_SYNC ) ? V_SYNC_POLARITY : !V_SYNC_POLARITY;
+    ff_delay #( .WIDTH( 4 + 2 * WIDTH ), .DEPTH( 1 ) ) output_delay
+    (
+        .clk(   clk ),
+        .D(     { w_hsync, w_vsync, w_h_active && w_v_active, w_frame_end, w_x, w_y } ),
+        .Q(     { hsync, vsync, de, frame_end, x, y } )
+    );
+endmodule
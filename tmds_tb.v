@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	tmds_tb.v
+//
+// Project:	tmds
+//
+// Purpose:	Test bench for tmds_encoder, random data, control periods and resets
+//          are compared against a reference encoder symbol by symbol.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// tmds_tb - feeds tmds_encoder random data periods of 1 to 64 clocks between control periods of 1 to 16
+//  clocks with random control, and pulses rst at random during the data periods. The reference encoder is
+//  the DVI 1.0 flow chart written out directly, fed LATENCY - 1 clocks late so its registered symbol lines
+//  up with tmds. Every symbol is compared.
+module tmds_tb
+    #(
+        parameter POPCOUNT_LATENCY  = 1,
+        parameter SYMBOLS           = 20000,
+        parameter SEED              = 1
+    );
+    localparam LATENCY  = 2 * POPCOUNT_LATENCY + 2;
+    localparam BENCH    = "tmds_tb";
+    localparam TIMEOUT  = 10 * ( SYMBOLS + LATENCY + 100 );
+
+    reg clk = 0;
+    always #5 clk = !clk;
+
+    reg         r_rst       = 0;
+    reg         r_de        = 0;
+    reg  [1:0]  r_control   = 0;
+    reg  [7:0]  r_data      = 0;
+    reg         r_running   = 0;
+    wire [9:0]  w_tmds;
+    tmds_encoder #( .POPCOUNT_LATENCY( POPCOUNT_LATENCY ) ) dut
+    (
+        .clk(       clk ),
+        .rst(       r_rst ),
+        .de(        r_de ),
+        .control(   r_control ),
+        .data(      r_data ),
+        .tmds(      w_tmds )
+    );
+    wire w_valid;
+    ff_delay #( .WIDTH( 1 ), .DEPTH( LATENCY ) ) valid_delay ( .clk( clk ), .D( r_running ), .Q( w_valid ) );
+    wire w_idle = !r_running && !w_valid;
+
+    `ifndef FORMAL
+        `include "./toolbox/test_bench.v"
+    `else
+        `include "test_bench.v"
+    `endif
+
+    // reference encoder
+    wire [7:0]  w_reference_data;
+    wire        w_reference_de;
+    wire [1:0]  w_reference_control;
+    ff_delay #( .WIDTH( 11 ), .DEPTH( LATENCY - 1 ) ) reference_delay
+    (
+        .clk(   clk ),
+        .D(     { r_data, r_de, r_control } ),
+        .Q(     { w_reference_data, w_reference_de, w_reference_control } )
+    );
+    reg     [9:0]   r_reference     = 0;
+    integer         reference_cnt   = 0;
+    integer         reference_ones;
+    integer         reference_qm_ones;
+    integer         bit_index;
+    reg     [8:0]   reference_qm;
+    always @( posedge clk ) begin
+        reference_ones = 0;
+        for( bit_index = 0; bit_index < 8; bit_index = bit_index + 1 )
+            reference_ones = reference_ones + w_reference_data[bit_index];
+        reference_qm[0] = w_reference_data[0];
+        for( bit_index = 1; bit_index < 8; bit_index = bit_index + 1 ) begin
+            if( reference_ones > 4 || ( reference_ones == 4 && w_reference_data[0] == 1'b0 ) )
+                reference_qm[bit_index] = ~( reference_qm[bit_index-1] ^ w_reference_data[bit_index] );
+            else
+                reference_qm[bit_index] = reference_qm[bit_index-1] ^ w_reference_data[bit_index];
+        end
+        reference_qm[8] = !( reference_ones > 4 || ( reference_ones == 4 && w_reference_data[0] == 1'b0 ) );
+        reference_qm_ones = 0;
+        for( bit_index = 0; bit_index < 8; bit_index = bit_index + 1 )
+            reference_qm_ones = reference_qm_ones + reference_qm[bit_index];
+        if( !w_reference_de ) begin
+            reference_cnt = 0;
+            case( w_reference_control )
+                2'b00:      r_reference <= 10'b1101010100;
+                2'b01:      r_reference <= 10'b0010101011;
+                2'b10:      r_reference <= 10'b0101010100;
+                default:    r_reference <= 10'b1010101011;
+            endcase
+        end else if( reference_cnt == 0 || reference_qm_ones == 4 ) begin
+            r_reference <= { ~reference_qm[8], reference_qm[8], reference_qm[8] ? reference_qm[7:0] : ~reference_qm[7:0] };
+            if( reference_qm[8] == 1'b0 )
+                reference_cnt = reference_cnt + ( 8 - reference_qm_ones ) - reference_qm_ones;
+            else
+                reference_cnt = reference_cnt + reference_qm_ones - ( 8 - reference_qm_ones );
+        end else if( ( reference_cnt > 0 && reference_qm_ones > 4 ) || ( reference_cnt < 0 && reference_qm_ones < 4 ) ) begin
+            r_reference <= { 1'b1, reference_qm[8], ~reference_qm[7:0] };
+            reference_cnt = reference_cnt + 2 * reference_qm[8] + ( 8 - reference_qm_ones ) - reference_qm_ones;
+        end else begin
+            r_reference <= { 1'b0, reference_qm[8], reference_qm[7:0] };
+            reference_cnt = reference_cnt - 2 * !reference_qm[8] + reference_qm_ones - ( 8 - reference_qm_ones );
+        end
+        // rst clears the disparity after the symbol of this clock, the same as the encoder
+        if( r_rst )
+            reference_cnt = 0;
+    end
+
+    always @( posedge clk ) begin
+        if( w_valid ) begin
+            if( w_tmds !== r_reference ) begin
+                if( r_errors < 10 )
+                    $display( "%t tmds %b, reference %b", $time, w_tmds, r_reference );
+                r_errors = r_errors + 1;
+            end
+            r_checked = r_checked + 1;
+        end
+    end
+
+    integer seed;
+    integer symbol;
+    integer period;
+    integer data_symbols;
+    integer resets;
+    initial begin
+        seed            = SEED;
+        symbol          = 0;
+        data_symbols    = 0;
+        resets          = 0;
+        @( posedge clk ); #1;
+        r_running = 1'b1;
+        while( symbol < SYMBOLS ) begin
+            // control period
+            r_de        = 1'b0;
+            r_control   = $random( seed );
+            for( period = 1 + { $random( seed ) } % 16; period != 0 && symbol < SYMBOLS; period = period - 1 ) begin
+                r_data  = $random( seed );
+                symbol  = symbol + 1;
+                @( posedge clk ); #1;
+            end
+            // data period
+            r_de        = 1'b1;
+            for( period = 1 + { $random( seed ) } % 64; period != 0 && symbol < SYMBOLS; period = period - 1 ) begin
+                r_data          = $random( seed );
+                r_control       = $random( seed );
+                r_rst           = { $random( seed ) } % 128 == 0;
+                resets          = resets + r_rst;
+                data_symbols    = data_symbols + 1;
+                symbol          = symbol + 1;
+                @( posedge clk ); #1;
+            end
+            r_rst = 1'b0;
+        end
+        r_running   = 1'b0;
+        r_de        = 1'b0;
+        wait_idle;
+
+        if( r_checked != SYMBOLS ) begin
+            $display( "%0d symbols checked of %0d", r_checked, SYMBOLS );
+            r_errors = r_errors + 1;
+        end
+        $display( "POPCOUNT_LATENCY %0d: %0d symbols, %0d data, %0d resets", POPCOUNT_LATENCY, SYMBOLS, data_symbols, resets );
+        test_bench_finish;
+    end
+endmodule
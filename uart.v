@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	uart.v
+//
+// Project:	uart
+//
+// Purpose:	Uart transmitter and receiver with a fractional baud rate tick,
+//          majority vote sampling and stream fifos.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// uart_baud_generator - 'tick' every divider + fraction / 2 ** FRACTION_WIDTH clocks on average
+//  The tick is the strobe of a counter_with_strobe. Every tick adds 'fraction' to an accumulator, a
+//  carry out makes the next period divider + 1 clocks, so the error never grows past 1 clock.
+//  divider >= 2 when fraction is not 0, divider + 1 has to fit DIVIDER_WIDTH bits.
+module uart_baud_generator
+    #(
+        parameter DIVIDER_WIDTH     = 16,
+        parameter FRACTION_WIDTH    = 8
+    )
+    (
+        input   wire                        clk,
+        input   wire                        rst,
+        input   wire [DIVIDER_WIDTH-1:0]    divider,
+        input   wire [FRACTION_WIDTH-1:0]   fraction,
+        output  wire                        tick
+    );
+    reg  [FRACTION_WIDTH-1:0]   r_accumulator   = 0;
+    reg                         r_extra         = 0;
+    always @( posedge clk ) begin
+        if( tick )
+            { r_extra, r_accumulator } <= { 1'b0, r_accumulator } + { 1'b0, fraction };
+        if( rst ) begin
+            r_accumulator   <= 'd0;
+            r_extra         <= 1'b0;
+        end
+    end
+
+    counter_with_strobe #( .WIDTH( DIVIDER_WIDTH ), .LATENCY( 0 ) ) tick_counter
+    (
+        .rst(           rst ),
+        .clk(           clk ),
+        .enable(        1'b1 ),
+        .reset_value(   divider + r_extra ),
+        .strobe(        tick ),
+        .ready(),
+        .valid()
+    );
+endmodule
+
+// uart - 8N1 style uart, 'OVERSAMPLE' ticks of uart_baud_generator per bit
+//  baud = clk / ( OVERSAMPLE * ( divider + fraction / 2 ** FRACTION_WIDTH ) ), OVERSAMPLE >= 4.
+//  tx - bytes queued through tx_valid / tx_ready are sent lsb first with a start bit and STOP_BITS stop
+//  bits, the next frame starts on the tick the last stop bit ends so a full fifo runs back to back.
+//  rx - uart_rx goes through a 'synchronizer', a falling edge starts a frame and every bit is the majority
+//  of the 3 ticks around its centre. The frame ends at the centre of the stop bit, so the receiver
+//  is ready for a start bit that follows without idle bits or on a slightly faster clock. A byte
+//  whose stop bit is 0 is dropped and pulses rx_frame_error, a byte the rx fifo has no room for is
+//  dropped and pulses rx_overrun.
+//  Both directions are valid / ready streams through fifo_sync fifos of 2 ** FIFO_ADDRESS_WIDTH bytes.
+module uart
+    #(
+        parameter DATA_BITS             = 8,
+        parameter STOP_BITS             = 1,
+        parameter OVERSAMPLE            = 8,
+        parameter DIVIDER_WIDTH         = 16,
+        parameter FRACTION_WIDTH        = 8,
+        parameter FIFO_ADDRESS_WIDTH    = 4
+    )
+    (
+        input   wire                        clk,
+        input   wire                        rst,
+        input   wire [DIVIDER_WIDTH-1:0]    divider,
+        input   wire [FRACTION_WIDTH-1:0]   fraction,
+        input   wire                        tx_valid,
+        output  wire                        tx_ready,
+        input   wire [DATA_BITS-1:0]        tx_data,
+        output  wire                        rx_valid,
+        input   wire                        rx_ready,
+        output  wire [DATA_BITS-1:0]        rx_data,
+        output  wire                        rx_frame_error,
+        output  wire                        rx_overrun,
+        output  wire                        uart_tx,
+        input   wire                        uart_rx
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    localparam FRAME_BITS   = 1 + DATA_BITS + STOP_BITS;
+    localparam PHASE_WIDTH  = f_Log2( OVERSAMPLE );
+    localparam BIT_WIDTH    = f_Log2( FRAME_BITS + 1 );
+    localparam CENTRE       = OVERSAMPLE / 2;
+
+    wire w_tick;
+    uart_baud_generator #( .DIVIDER_WIDTH( DIVIDER_WIDTH ), .FRACTION_WIDTH( FRACTION_WIDTH ) ) baud_generator
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .divider(   divider ),
+        .fraction(  fraction ),
+        .tick(      w_tick )
+    );
+
+    // transmitter
+    wire                    w_tx_valid;
+    wire                    w_tx_pop;
+    wire [DATA_BITS-1:0]    w_tx_data;
+    fifo_sync #( .WIDTH( DATA_BITS ), .ADDRESS_WIDTH( FIFO_ADDRESS_WIDTH ) ) tx_fifo
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  tx_valid ),
+        .in_ready(  tx_ready ),
+        .in_data(   tx_data ),
+        .out_valid( w_tx_valid ),
+        .out_ready( w_tx_pop ),
+        .out_data(  w_tx_data ),
+        .count()
+    );
+
+    reg                     r_tx_busy   = 0;
+    reg  [FRAME_BITS-1:0]   r_tx_shift  = { FRAME_BITS{1'b1} };
+    reg  [PHASE_WIDTH-1:0]  r_tx_phase  = 0;
+    reg  [BIT_WIDTH-1:0]    r_tx_bits   = 0;    // bits left - 1
+    wire                    w_tx_end    = w_tick && r_tx_phase == OVERSAMPLE - 1 && r_tx_bits == 0;
+    assign w_tx_pop = w_tx_valid && ( !r_tx_busy || w_tx_end );
+    assign uart_tx  = r_tx_shift[0];
+    always @( posedge clk ) begin
+        if( r_tx_busy && w_tick ) begin
+            r_tx_phase <= r_tx_phase + 1'b1;
+            if( r_tx_phase == OVERSAMPLE - 1 ) begin
+                r_tx_phase  <= 'd0;
+                r_tx_shift  <= { 1'b1, r_tx_shift[FRAME_BITS-1:1] };
+                r_tx_bits   <= r_tx_bits - 1'b1;
+            end
+            if( w_tx_end )
+                r_tx_busy <= 1'b0;
+        end
+        if( w_tx_pop ) begin
+            r_tx_busy   <= 1'b1;
+            r_tx_shift  <= { { STOP_BITS{1'b1} }, w_tx_data, 1'b0 };
+            r_tx_phase  <= 'd0;
+            r_tx_bits   <= FRAME_BITS - 1;
+        end
+        if( rst ) begin
+            r_tx_busy   <= 1'b0;
+            r_tx_shift  <= { FRAME_BITS{1'b1} };
+        end
+    end
+
+    // receiver
+    wire w_rx;
+    synchronizer #( .DEPTH_INPUT( 0 ), .DEPTH_OUTPUT( 2 ), .INIT( 1'b1 ) ) rx_synchronizer
+    (
+        .clk_in(    clk ),
+        .in(        uart_rx ),
+        .clk_out(   clk ),
+        .out(       w_rx )
+    );
+
+    reg                     r_rx_busy       = 0;
+    reg  [PHASE_WIDTH-1:0]  r_rx_phase      = 0;
+    reg  [BIT_WIDTH-1:0]    r_rx_bit        = 0;    // 0 start, 1 .. DATA_BITS data, DATA_BITS + 1 stop
+    reg  [1:0]              r_rx_votes      = 0;
+    reg  [DATA_BITS-1:0]    r_rx_shift      = 0;
+    reg                     r_frame_error   = 0;
+    reg                     r_overrun       = 0;
+    wire                    w_vote          = ( r_rx_votes[1] && r_rx_votes[0] ) || ( r_rx_votes[1] && w_rx ) || ( r_rx_votes[0] && w_rx );
+    wire                    w_decide        = w_tick && r_rx_busy && r_rx_phase == CENTRE + 1;
+    wire                    w_stop          = w_decide && r_rx_bit == DATA_BITS + 1;
+    wire                    w_rx_push       = w_stop && w_vote;
+    wire                    w_rx_ready;
+    assign rx_frame_error   = r_frame_error;
+    assign rx_overrun       = r_overrun;
+    always @( posedge clk ) begin
+        r_frame_error   <= w_stop && !w_vote;
+        r_overrun       <= w_rx_push && !w_rx_ready;
+        if( w_tick ) begin
+            if( !r_rx_busy ) begin
+                // the falling edge is phase 0 of the start bit
+                if( !w_rx ) begin
+                    r_rx_busy   <= 1'b1;
+                    r_rx_phase  <= 'd1;
+                    r_rx_bit    <= 'd0;
+                end
+            end else begin
+                r_rx_phase <= r_rx_phase + 1'b1;
+                if( r_rx_phase == OVERSAMPLE - 1 ) begin
+                    r_rx_phase  <= 'd0;
+                    r_rx_bit    <= r_rx_bit + 1'b1;
+                end
+                if( r_rx_phase >= CENTRE - 1 && r_rx_phase <= CENTRE + 1 )
+                    r_rx_votes <= { r_rx_votes[0], w_rx };
+            end
+        end
+        if( w_decide ) begin
+            if( r_rx_bit == 0 ) begin
+                if( w_vote )                // a glitch, not a start bit
+                    r_rx_busy <= 1'b0;
+            end else if( r_rx_bit <= DATA_BITS )
+                r_rx_shift <= { w_vote, r_rx_shift[DATA_BITS-1:1] };
+            else
+                r_rx_busy <= 1'b0;
+        end
+        if( rst ) begin
+            r_rx_busy       <= 1'b0;
+            r_frame_error   <= 1'b0;
+            r_overrun       <= 1'b0;
+        end
+    end
+
+    fifo_sync #( .WIDTH( DATA_BITS ), .ADDRESS_WIDTH( FIFO_ADDRESS_WIDTH ) ) rx_fifo
+    (
+        .clk(       clk ),
+        .rst(       rst ),
+        .in_valid(  w_rx_push ),
+        .in_ready(  w_rx_ready ),
+        .in_data(   r_rx_shift ),
+        .out_valid( rx_valid ),
+        .out_ready( rx_ready ),
+        .out_data(  rx_data ),
+        .count()
+    );
+endmodule
@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Filename:	unit_farm.v
+//
+// Project:	unit farm
+//
+// Purpose:	Dispatches an in order stream over several copies of a variable
+//          latency unit and restores the order with a reorder buffer.
+//
+// Creator:	Ronald Rainwater
+// Data: 2026-10-18
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2024, Ronald Rainwater
+//
+// This program is free software (firmware): you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+// for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program. If not, see <http://www.gnu.org/licenses/> for a copy.
+// License:	GPL, v3, as defined and found on www.gnu.org,
+//		http://www.gnu.org/licenses/gpl.html
+////////////////////////////////////////////////////////////////////////////////
+`default_nettype none
+
+// unit_farm - UNITS copies of a unit behind a single in order stream
+//  The units are connected to the unit_* ports, unit n uses bit n of unit_in_valid, unit_in_ready
+//  and unit_out_valid, and unit_results[n*RESULT_WIDTH+:RESULT_WIDTH]. All units share unit_operands.
+//  A unit may take any number of clocks, math_sqrt with ITERATIVE 1 for example, but its results
+//  MUST leave in the order its operations were taken, and it MUST NOT hold more than UNIT_DEPTH
+//  operations at once.
+//
+//  dispatch    the request goes to the first ready unit after the last unit used, round robin, and
+//              is given the next slot of the reorder buffer. The slot number is pushed into the
+//              unit's tag queue, the unit itself never sees it.
+//  complete    a unit result pops the unit's tag queue and is written to that slot, every unit
+//              can complete on the same clock.
+//  retire      the oldest slot leaves on out_result once it is complete and out_ready is set.
+//  Up to ROB_DEPTH operations can be in flight, with K units busy for L clocks each the farm
+//  sustains K / L operations per clock while ROB_DEPTH >= K * UNIT_DEPTH.
+//  ROB_DEPTH MUST BE a power of 2, >= 2.
+module unit_farm
+    #(
+        parameter UNITS         = 4,
+        parameter OPERAND_WIDTH = 32,
+        parameter RESULT_WIDTH  = 16,
+        parameter UNIT_DEPTH    = 1,
+        parameter ROB_DEPTH     = 8
+    )
+    (
+        input   wire                                clk,
+        input   wire                                rst,
+        // in order stream
+        input   wire                                in_valid,
+        output  wire                                in_ready,
+        input   wire    [OPERAND_WIDTH-1:0]         in_operands,
+        output  wire                                out_valid,
+        input   wire                                out_ready,
+        output  wire    [RESULT_WIDTH-1:0]          out_result,
+        // units
+        output  wire    [UNITS-1:0]                 unit_in_valid,
+        input   wire    [UNITS-1:0]                 unit_in_ready,
+        output  wire    [OPERAND_WIDTH-1:0]         unit_operands,
+        input   wire    [UNITS-1:0]                 unit_out_valid,
+        input   wire    [UNITS*RESULT_WIDTH-1:0]    unit_results
+    );
+    `ifndef FORMAL
+        `include "./toolbox/recursion_iterators.v"
+    `else
+        `include "recursion_iterators.v"
+    `endif
+    localparam ROB_ADDR     = f_Log2( ROB_DEPTH );
+    localparam QUEUE_ADDR   = f_Log2( UNIT_DEPTH );
+
+    // reorder buffer, the pointers have an extra bit to tell full from empty
+    reg  [ROB_ADDR:0]           r_head      = 0;
+    reg  [ROB_ADDR:0]           r_tail      = 0;
+    reg  [ROB_DEPTH-1:0]        r_done      = 0;
+    reg  [RESULT_WIDTH-1:0]     r_result [0:ROB_DEPTH-1];
+    // tag queues, 1 per unit
+    reg  [ROB_ADDR-1:0]         r_queue [0:UNITS*UNIT_DEPTH-1];
+    reg  [UNITS*QUEUE_ADDR-1:0] r_queue_write   = 0;
+    reg  [UNITS*QUEUE_ADDR-1:0] r_queue_read    = 0;
+    reg  [UNITS*(QUEUE_ADDR+1)-1:0] r_queue_count = 0;
+
+    // a unit is free when it is ready and its tag queue has room
+    wire [UNITS-1:0] w_unit_free;
+    genvar idx;
+    generate
+        for( idx = 0; idx < UNITS; idx = idx + 1 ) begin : unit_free_loop
+            assign w_unit_free[idx] = unit_in_ready[idx] && r_queue_count[idx*(QUEUE_ADDR+1)+:QUEUE_ADDR+1] != UNIT_DEPTH;
+        end
+    endgenerate
+
+    // round robin, the lowest free unit above the last grant wins, otherwise the lowest free unit
+    reg  [UNITS-1:0]    r_last_grant    = 1;
+    wire [UNITS-1:0]    w_above         = ~( ( r_last_grant << 1 ) - 1'b1 );
+    wire [UNITS-1:0]    w_masked        = w_unit_free & w_above;
+    wire [UNITS-1:0]    w_candidates    = |w_masked ? w_masked : w_unit_free;
+    wire [UNITS-1:0]    w_grant         = w_candidates & ( ~w_candidates + 1'b1 );
+
+    wire [ROB_ADDR:0]   w_used      = r_tail - r_head;
+    wire                w_full      = w_used == ROB_DEPTH;
+    wire                w_dispatch  = in_valid && !w_full && |w_unit_free;
+    wire                w_retire    = out_valid && out_ready;
+    assign in_ready         = !w_full && |w_unit_free;
+    assign unit_in_valid    = w_dispatch ? w_grant : { UNITS{1'b0} };
+    assign unit_operands    = in_operands;
+    assign out_valid        = r_head != r_tail && r_done[r_head[ROB_ADDR-1:0]];
+    assign out_result       = r_result[r_head[ROB_ADDR-1:0]];
+
+    integer unit;
+    reg [ROB_ADDR-1:0]      slot;
+    reg [QUEUE_ADDR-1:0]    queue_read;
+    reg [QUEUE_ADDR-1:0]    queue_write;
+    always @( posedge clk ) begin
+        if( w_retire ) begin
+            r_done[r_head[ROB_ADDR-1:0]]    <= 1'b0;
+            r_head                          <= r_head + 1'b1;
+        end
+        if( w_dispatch ) begin
+            r_tail          <= r_tail + 1'b1;
+            r_last_grant    <= w_grant;
+        end
+        for( unit = 0; unit < UNITS; unit = unit + 1 ) begin
+            queue_read  = r_queue_read[unit*QUEUE_ADDR+:QUEUE_ADDR];
+            queue_write = r_queue_write[unit*QUEUE_ADDR+:QUEUE_ADDR];
+            // complete
+            if( unit_out_valid[unit] ) begin
+                slot                = r_queue[unit*UNIT_DEPTH+queue_read];
+                r_result[slot]      <= unit_results[unit*RESULT_WIDTH+:RESULT_WIDTH];
+                r_done[slot]        <= 1'b1;
+                r_queue_read[unit*QUEUE_ADDR+:QUEUE_ADDR] <= queue_read == UNIT_DEPTH - 1 ? 'd0 : queue_read + 1'b1;
+            end
+            // dispatch
+            if( w_dispatch && w_grant[unit] ) begin
+                r_queue[unit*UNIT_DEPTH+queue_write] <= r_tail[ROB_ADDR-1:0];
+                r_queue_write[unit*QUEUE_ADDR+:QUEUE_ADDR] <= queue_write == UNIT_DEPTH - 1 ? 'd0 : queue_write + 1'b1;
+            end
+            r_queue_count[unit*(QUEUE_ADDR+1)+:QUEUE_ADDR+1] <= r_queue_count[unit*(QUEUE_ADDR+1)+:QUEUE_ADDR+1]
+                + ( w_dispatch && w_grant[unit] ) - unit_out_valid[unit];
+        end
+        if( rst ) begin
+            r_head          <= 'd0;
+            r_tail          <= 'd0;
+            r_done          <= 'd0;
+            r_last_grant    <= 1;
+            r_queue_write   <= 'd0;
+            r_queue_read    <= 'd0;
+            r_queue_count   <= 'd0;
+        end
+    end
+endmodule